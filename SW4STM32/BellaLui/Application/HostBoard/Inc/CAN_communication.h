@@ -38,12 +38,23 @@ typedef struct
 
 #define DATA_ID_TEMPERATURE 12 // cDegC
 #define DATA_ID_CALIB_PRESSURE 13 // Pa
+#define DATA_ID_SAMPLING_JITTER 14 // us, standard deviation of the sensor sampling period
+#define DATA_ID_SAMPLING_LATENCY 15 // us, longest delay from a sampling trigger to its acquisition
 
 #define DATA_ID_AB_STATE   16 // enum
 #define DATA_ID_AB_INC     17 // [-]
 #define DATA_ID_AB_AIRSPEED 18 // mm/s
 #define DATA_ID_AB_ALT     19 // m
 
+#define DATA_ID_SENSOR_HEALTH 20 // enum Sensor_health, 2 bits per sensor: the IMUs then the baros
+
+// fused sample of the sensor board, one group of frames per cycle stamped with its trigger
+#define DATA_ID_SAMPLE_ACCEL_XY       21 // milli-g, can_packHalves
+#define DATA_ID_SAMPLE_ACCEL_Z_GYRO_X 22 // milli-g and mrps, can_packHalves
+#define DATA_ID_SAMPLE_GYRO_YZ        23 // mrps, can_packHalves, last of the IMU sample
+#define DATA_ID_SAMPLE_BARO           24 // Pa and cDegC, can_packBaro, only with a new conversion and stamped with its time
+#define DATA_ID_SAMPLE_FRAMES 4
+
 #define DATA_ID_KALMAN_STATE 38 // enum
 #define DATA_ID_KALMAN_X     40 // m
 #define DATA_ID_KALMAN_Y     41 // m
@@ -60,6 +71,9 @@ typedef struct
 #define DATA_ID_ORDER 51
 #define DATA_ID_IGNITION 51
 
+// the same frames with the data of each sensor, at DATA_ID_RAW_SAMPLE + DATA_ID_SAMPLE_FRAMES * sensor_id + frame
+#define DATA_ID_RAW_SAMPLE 60 // up to 75
+
 // Define all the board ID's (lower means higher priority for CAN protocol)
 #define CAN_ID_MAIN_BOARD 0
 #define CAN_ID_GPS_BOARD 1
@@ -71,6 +85,53 @@ typedef struct
 #define MAX_BOARD_ID 7 // used to implement redundant info in CAN_handling
 #define MAX_BOARD_NUMBER (MAX_BOARD_ID+1)
 
+/*
+ * Two values in the 32 bits of a frame, each saturated to 16 bits, the first one in the
+ * upper half.
+ */
+static inline uint32_t can_packHalves(int32_t high, int32_t low)
+{
+	high = high > INT16_MAX ? INT16_MAX : (high < INT16_MIN ? INT16_MIN : high);
+	low = low > INT16_MAX ? INT16_MAX : (low < INT16_MIN ? INT16_MIN : low);
+	return ((uint32_t) (uint16_t) high << 16) | (uint16_t) low;
+}
+
+static inline int16_t can_highHalf(uint32_t data)
+{
+	return (int16_t) (data >> 16);
+}
+
+static inline int16_t can_lowHalf(uint32_t data)
+{
+	return (int16_t) data;
+}
+
+/*
+ * The pressure in the upper 17 bits, up to 1310 hPa, and the temperature in the lower
+ * 15 bits, within +-163 DegC.
+ */
+#define CAN_BARO_TEMPERATURE_BITS 15
+
+static inline uint32_t can_packBaro(int32_t pressure, int32_t temperature)
+{
+	const int32_t pressure_max = (1 << (32 - CAN_BARO_TEMPERATURE_BITS)) - 1;
+	const int32_t temperature_max = (1 << (CAN_BARO_TEMPERATURE_BITS - 1)) - 1;
+
+	pressure = pressure > pressure_max ? pressure_max : (pressure < 0 ? 0 : pressure);
+	temperature = temperature > temperature_max ? temperature_max : (temperature < -temperature_max ? -temperature_max : temperature);
+	return ((uint32_t) pressure << CAN_BARO_TEMPERATURE_BITS) | ((uint32_t) temperature & ((1 << CAN_BARO_TEMPERATURE_BITS) - 1));
+}
+
+static inline int32_t can_baroPressure(uint32_t data)
+{
+	return data >> CAN_BARO_TEMPERATURE_BITS;
+}
+
+static inline int32_t can_baroTemperature(uint32_t data)
+{
+	return ((int32_t) (data << (32 - CAN_BARO_TEMPERATURE_BITS))) >> (32 - CAN_BARO_TEMPERATURE_BITS);
+}
+
 void CAN_Config(uint32_t id);
 void can_setFrame(uint32_t data, uint8_t data_id, uint32_t timestamp);
 
@@ -0,0 +1,20 @@
+/*
+ * apogee_predictor.h
+ *
+ * Apogee of the coasting rocket, integrated on board from the current altitude and
+ * speed with the drag of a given opening of the airbrakes.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef AIRBRAKES_APOGEE_PREDICTOR_H_
+#define AIRBRAKES_APOGEE_PREDICTOR_H_
+
+#define APOGEE_STEP_S (0.1f) // [s] integration step
+#define APOGEE_MAX_STEPS (400) // bounds the cost of a prediction, 40 s of coasting
+#define APOGEE_SOLVER_ITERATIONS (4) // predictions refining the opening, after both extremes
+
+float apogee_predict (float altitude, float speed, float opening_deg);
+float apogee_opening (float altitude, float speed, float max_opening_deg);
+
+#endif /* AIRBRAKES_APOGEE_PREDICTOR_H_ */
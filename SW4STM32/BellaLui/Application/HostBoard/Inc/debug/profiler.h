@@ -0,0 +1,35 @@
+/*
+ * profiler.h
+ *
+ * Cycle-accurate timing of code sections with the DWT cycle counter of the Cortex-M4.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef DEBUG_PROFILER_H_
+#define DEBUG_PROFILER_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+static inline void profiler_init()
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t profiler_cycles()
+{
+	return DWT->CYCCNT;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEBUG_PROFILER_H_ */
@@ -0,0 +1,350 @@
+/*
+ * ekf.h
+ *
+ * Extended Kalman filter with N states and M observables fixed at compile time.
+ *
+ * Same algorithm as TinyEKF (tiny_ekf.c). N and M are template parameters and the
+ * matrices are plain members: nothing is unpacked at run time, and the dense products
+ * have constant bounds.
+ *
+ * The Jacobians of a rocket model are mostly zeros (blocks of position, velocity and
+ * attitude, a few selected states observed), so the step multiplies by F and H through
+ * their non-zero entries only, and updates P as P - G (H P) instead of (I - G H) P.
+ * The result equals the dense one of ekf_step up to rounding. Those entries depend on
+ * the model, and for a rotating rocket on its state, so F and H are scanned at every
+ * step: the inner loops of the sparse products run over a count known at run time only
+ * and are not unrolled. The scan costs N N + M N comparisons per step, far less than
+ * the multiply-accumulates it saves.
+ *
+ * With a diagonal R, predict() followed by update() for each available observable gives
+ * the same estimate as step() without any matrix inversion: every observation is a scalar
+ * update, and the observables which were not measured are simply not updated.
+ *
+ * Like with ekf_step, the caller fills fx, F, hx and H before each step.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef KALMAN_EKF_H_
+#define KALMAN_EKF_H_
+
+#include <math.h>
+#include <stdint.h>
+#include <kalman/ekf_kernels.h>
+
+template<int R, int C>
+struct Matrix
+{
+    float m[R][C];
+
+    float * operator[](int r) { return m[r]; }
+    const float * operator[](int r) const { return m[r]; }
+};
+
+template<int N>
+struct Vector
+{
+    float v[N];
+
+    float & operator[](int i) { return v[i]; }
+    float operator[](int i) const { return v[i]; }
+};
+
+/* Columns of the non-zero entries of each row of a matrix, found at run time by scan() */
+template<int R, int C>
+struct Sparsity
+{
+    uint8_t count[R];
+    uint8_t cols[R][C];
+    uint8_t total;
+
+    void scan(const Matrix<R, C> & a)
+    {
+        total = 0;
+        for(int i=0; i<R; ++i) {
+            count[i] = 0;
+            for(int j=0; j<C; ++j)
+                if (a[i][j] != 0)
+                    cols[i][count[i]++] = j;
+            total += count[i];
+        }
+    }
+};
+
+namespace ekf_ops
+{
+    /* C <- A * B */
+    template<int R, int K, int C>
+    inline void mul(const Matrix<R, K> & a, const Matrix<K, C> & b, Matrix<R, C> & c)
+    {
+        for(int i=0; i<R; ++i)
+            for(int j=0; j<C; ++j)
+                c[i][j] = ekf_dot(a[i], 1, &b[0][j], C, K);
+    }
+
+    /* C <- A * B^T */
+    template<int R, int K, int C>
+    inline void mul_t(const Matrix<R, K> & a, const Matrix<C, K> & b, Matrix<R, C> & c)
+    {
+        for(int i=0; i<R; ++i)
+            for(int j=0; j<C; ++j)
+                c[i][j] = ekf_dot(a[i], 1, b[j], 1, K);
+    }
+
+    /* y <- A * x */
+    template<int R, int C>
+    inline void mul(const Matrix<R, C> & a, const Vector<C> & x, Vector<R> & y)
+    {
+        for(int i=0; i<R; ++i)
+            y[i] = ekf_dot(a[i], 1, x.v, 1, C);
+    }
+
+    /* C <- A * B, A sparse */
+    template<int R, int K, int C>
+    inline void mul(const Sparsity<R, K> & as, const Matrix<R, K> & a, const Matrix<K, C> & b, Matrix<R, C> & c)
+    {
+        for(int i=0; i<R; ++i)
+            for(int j=0; j<C; ++j) {
+                float s = 0;
+                for(int t=0; t<as.count[i]; ++t)
+                    s += a[i][as.cols[i][t]] * b[as.cols[i][t]][j];
+                c[i][j] = s;
+            }
+    }
+
+    /* C <- A * B^T, B sparse */
+    template<int R, int K, int C>
+    inline void mul_t(const Matrix<R, K> & a, const Sparsity<C, K> & bs, const Matrix<C, K> & b, Matrix<R, C> & c)
+    {
+        for(int i=0; i<R; ++i)
+            for(int j=0; j<C; ++j) {
+                float s = 0;
+                for(int t=0; t<bs.count[j]; ++t)
+                    s += a[i][bs.cols[j][t]] * b[j][bs.cols[j][t]];
+                c[i][j] = s;
+            }
+    }
+
+    /* A <- A + B */
+    template<int R, int C>
+    inline void accum(Matrix<R, C> & a, const Matrix<R, C> & b)
+    {
+        for(int i=0; i<R; ++i)
+            for(int j=0; j<C; ++j)
+                a[i][j] += b[i][j];
+    }
+}
+
+template<int N, int M>
+class Ekf
+{
+public:
+    Vector<N> x {};       /* state vector */
+
+    Matrix<N, N> P {};    /* prediction error covariance */
+    Matrix<N, N> Q {};    /* process noise covariance */
+    Matrix<M, M> R {};    /* measurement error covariance */
+
+    Matrix<N, M> G {};    /* Kalman gain; a.k.a. K */
+
+    Matrix<N, N> F {};    /* Jacobian of process model */
+    Matrix<M, N> H {};    /* Jacobian of measurement model */
+
+    Vector<N> fx {};      /* output of user defined f() state-transition function */
+    Vector<M> hx {};      /* output of user defined h() measurement function */
+
+    /* multiply-accumulates of the dense step, as done by ekf_step */
+    static constexpr uint32_t DENSE_MACS = 3*N*N*N + 3*N*N*M + 2*N*M*M + N*M;
+
+    /* multiply-accumulates of the last step, or of the last prediction and the updates following it */
+    uint32_t macs() const { return mac_count; }
+
+    /*
+     * Runs one step of prediction and update.
+     * Returns false, leaving x and P untouched, if the innovation covariance is not positive-definite.
+     */
+    bool step(const Vector<M> & z)
+    {
+        using namespace ekf_ops;
+
+        Fs.scan(F);
+        Hs.scan(H);
+
+        mac_count = 2*N*Fs.total + 2*N*Hs.total + M*Hs.total + N*M*M + N*M;
+        for(int r=0; r<M; ++r)
+            if (Hs.count[r]) mac_count += N*N;
+
+        /* P_k = F_{k-1} P_{k-1} F^T_{k-1} + Q_{k-1} */
+        mul(Fs, F, P, tmp0);
+        mul_t(tmp0, Fs, F, Pp);
+        accum(Pp, Q);
+
+        /* G_k = P_k H^T_k (H_k P_k H^T_k + R)^{-1} */
+        mul_t(Pp, Hs, H, tmp1);
+        mul(Hs, H, Pp, tmp2);
+        mul_t(tmp2, Hs, H, tmp3);
+        accum(tmp3, R);
+        if (!cholsl(tmp3, tmp4, tmp5.v)) return false;
+        mul(tmp1, tmp4, G);
+
+        /* \hat{x}_k = \hat{x_k} + G_k(z_k - h(\hat{x}_k)) */
+        for(int i=0; i<M; ++i)
+            tmp5[i] = z[i] - hx[i];
+        mul(G, tmp5, dx);
+        for(int i=0; i<N; ++i)
+            x[i] = fx[i] + dx[i];
+
+        /* P_k = (I - G_k H_k) P_k = P_k - G_k (H_k P_k), skipping the unobserved rows of H_k P_k */
+        P = Pp;
+        for(int r=0; r<M; ++r) {
+            if (Hs.count[r] == 0) continue;
+            for(int i=0; i<N; ++i)
+                for(int j=0; j<N; ++j)
+                    P[i][j] -= G[i][r] * tmp2[r][j];
+        }
+
+        return true;
+    }
+
+    /*
+     * Prediction alone, to be followed by update() for each available observable:
+     * x_k = f(x_{k-1}), P_k = F_{k-1} P_{k-1} F^T_{k-1} + Q_{k-1}
+     */
+    void predict()
+    {
+        using namespace ekf_ops;
+
+        Fs.scan(F);
+        mac_count = 2*N*Fs.total;
+
+        mul(Fs, F, P, tmp0);
+        mul_t(tmp0, Fs, F, P);
+        accum(P, Q);
+        x = fx;
+    }
+
+    /*
+     * Scalar update with the measurement z of observable r, assuming R diagonal.
+     * hx and H are those of the last prediction: the innovation accounts for the updates
+     * already applied since. Nothing is done if row r of H is zero.
+     * Returns false, leaving x and P untouched, if the innovation variance is not positive.
+     */
+    bool update(int r, float z)
+    {
+        uint8_t cols[N];
+        int count = 0;
+
+        for(int k=0; k<N; ++k)
+            if (H[r][k] != 0)
+                cols[count++] = k;
+
+        if (count == 0) return true;
+
+        /* P_k H_r^T and H_r P_k, apart since P_k is not exactly symmetric */
+        for(int i=0; i<N; ++i) {
+            float a = 0, b = 0;
+            for(int t=0; t<count; ++t) {
+                a += P[i][cols[t]] * H[r][cols[t]];
+                b += H[r][cols[t]] * P[cols[t]][i];
+            }
+            ph[i] = a;
+            hp[i] = b;
+        }
+
+        /* innovation and its variance H_r P_k H_r^T + R_r */
+        float s = R[r][r];
+        float y = z - hx[r];
+        for(int t=0; t<count; ++t) {
+            s += H[r][cols[t]] * ph[cols[t]];
+            y -= H[r][cols[t]] * (x[cols[t]] - fx[cols[t]]);
+        }
+
+        if (!(s > 0)) return false;
+
+        /* x_k += g y, P_k -= g H_r P_k, with the gain g = P_k H_r^T / s */
+        const float inv = 1 / s;
+        for(int i=0; i<N; ++i) {
+            const float g = ph[i] * inv;
+            x[i] += g * y;
+            for(int j=0; j<N; ++j)
+                P[i][j] -= g * hp[j];
+        }
+
+        mac_count += 2*N*count + 2*count + N + N*N;
+        return true;
+    }
+
+private:
+    Matrix<N, N> Pp;      /* P, post-prediction, pre-update */
+
+    /* temporary storage */
+    Matrix<N, N> tmp0;
+    Matrix<N, M> tmp1;
+    Matrix<M, N> tmp2;
+    Matrix<M, M> tmp3;
+    Matrix<M, M> tmp4;
+    Vector<M> tmp5;
+    Vector<N> dx;
+    Vector<N> ph;
+    Vector<N> hp;
+
+    uint32_t mac_count = 0;
+
+    /* non-zero entries of the Jacobians, found at each step */
+    Sparsity<N, N> Fs {};
+    Sparsity<M, N> Hs {};
+
+    /* Cholesky-decomposition matrix inversion, same steps as choldc1/choldcsl/cholsl in tiny_ekf.c */
+    static bool cholsl(const Matrix<M, M> & A, Matrix<M, M> & a, float * p)
+    {
+        float sum;
+
+        a = A;
+
+        for(int i=0; i<M; i++) {
+            for(int j=i; j<M; j++) {
+                sum = a[i][j];
+                for(int k=i-1; k>=0; k--)
+                    sum -= a[i][k] * a[j][k];
+                if (i == j) {
+                    if (sum <= 0) return false;
+                    p[i] = sqrtf(sum);
+                }
+                else {
+                    a[j][i] = sum / p[i];
+                }
+            }
+        }
+
+        for(int i=0; i<M; i++) {
+            a[i][i] = 1 / p[i];
+            for(int j=i+1; j<M; j++) {
+                sum = 0;
+                for(int k=i; k<j; k++)
+                    sum -= a[j][k] * a[k][i];
+                a[j][i] = sum / p[j];
+            }
+        }
+
+        for(int i=0; i<M; i++)
+            for(int j=i+1; j<M; j++)
+                a[i][j] = 0.0;
+
+        for(int i=0; i<M; i++) {
+            a[i][i] *= a[i][i];
+            for(int k=i+1; k<M; k++)
+                a[i][i] += a[k][i] * a[k][i];
+            for(int j=i+1; j<M; j++)
+                for(int k=j; k<M; k++)
+                    a[i][j] += a[k][i] * a[k][j];
+        }
+
+        for(int i=0; i<M; i++)
+            for(int j=0; j<i; j++)
+                a[i][j] = a[j][i];
+
+        return true;
+    }
+};
+
+#endif /* KALMAN_EKF_H_ */
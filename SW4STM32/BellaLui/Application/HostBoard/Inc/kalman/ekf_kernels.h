@@ -0,0 +1,55 @@
+/*
+ * ekf_kernels.h
+ *
+ * Dot product shared by the dense matrix products of tiny_ekf.c and of the Ekf template
+ * (kalman/ekf.h), so that both compute these elements in the same order.
+ *
+ * On an FPU with fused multiply-add (the Cortex-M4F, or a host built with -mfma) the
+ * products accumulate in registers, four independent sums at a time. Define
+ * EKF_SCALAR_KERNELS to fall back to a single running sum, as the original TinyEKF loops.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef KALMAN_EKF_KERNELS_H_
+#define KALMAN_EKF_KERNELS_H_
+
+#if (defined(__ARM_FEATURE_FMA) || defined(__FMA__)) && !defined(EKF_SCALAR_KERNELS)
+
+#define EKF_FMA(a, b, acc) __builtin_fmaf((a), (b), (acc))
+
+/* dot product of two strided vectors of length n */
+static inline float ekf_dot(const float * a, int astride, const float * b, int bstride, int n)
+{
+    float s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    int l = 0;
+
+    for(; l+3<n; l+=4) {
+        s0 = EKF_FMA(a[(l+0)*astride], b[(l+0)*bstride], s0);
+        s1 = EKF_FMA(a[(l+1)*astride], b[(l+1)*bstride], s1);
+        s2 = EKF_FMA(a[(l+2)*astride], b[(l+2)*bstride], s2);
+        s3 = EKF_FMA(a[(l+3)*astride], b[(l+3)*bstride], s3);
+    }
+    for(; l<n; ++l)
+        s0 = EKF_FMA(a[l*astride], b[l*bstride], s0);
+
+    return (s0 + s1) + (s2 + s3);
+}
+
+#else
+
+/* dot product of two strided vectors of length n */
+static inline float ekf_dot(const float * a, int astride, const float * b, int bstride, int n)
+{
+    float s = 0;
+    int l;
+
+    for(l=0; l<n; ++l)
+        s += a[l*astride] * b[l*bstride];
+
+    return s;
+}
+
+#endif
+
+#endif /* KALMAN_EKF_KERNELS_H_ */
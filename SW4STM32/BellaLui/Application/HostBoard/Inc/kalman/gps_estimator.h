@@ -0,0 +1,106 @@
+/*
+ * gps_estimator.h
+ *
+ * Navigation filter of TK_kalman, without any RTOS or CAN: one step per IMU sample,
+ * fusing the GPS and baro measurements at their own time. TK_kalman feeds it from
+ * its queues, and the same calls run it on recorded or simulated data.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef KALMAN_GPS_ESTIMATOR_H_
+#define KALMAN_GPS_ESTIMATOR_H_
+
+#include <stdint.h>
+#include <kalman/tinyekf_config.h>
+#include <kalman/ekf.h>
+#include <kalman/quaternion.h>
+
+#define EKF_HISTORY_LENGTH (16) // steps kept to fuse delayed measurements, 160 ms at 100 Hz
+
+// observables updated at a step, one bit per row of H
+#define OBSERVED_GPS (0x07)
+#define OBSERVED_BARO (0x08)
+
+typedef Ekf<Nsta, Mobs> GpsEkf;
+
+typedef struct {
+    float IMUb[6]; // accelerations [m/s^2] and rotation speeds, in the body frame
+    uint32_t timestamp; // [ms]
+} IMU_sample;
+
+typedef struct {
+    uint8_t observed; // observables measured, one bit per row of H
+    float z[Mobs];
+    uint32_t timestamp; // [ms]
+} Measurement;
+
+class GpsEstimator
+{
+public:
+    // state, covariances and attitude of the filter at rest
+    void init();
+
+    /*
+     * Adds a measurement to the step at or after its time stamp: the coming one, or an
+     * earlier one run again by the next call to step(). Returns false if the measurement
+     * is older than the history, and thus ignored.
+     */
+    bool add(const Measurement & m);
+
+    /*
+     * Predicts over dt [s] with the IMU sample and updates with the measurements added
+     * for it. Returns 0 on success, 1 if an update was rejected.
+     */
+    int step(const IMU_sample & sample, float dt);
+
+    const Vector<Nsta> & state() const { return ekf.x; }
+    const Quaternion & orientation() const { return attitude; }
+
+    uint32_t steps() const { return step_count; }
+    uint32_t replayed() const { return replayed_count; } // steps run again by the last step()
+    uint32_t macs() const { return ekf.macs(); }
+
+    uint32_t model_cycles = 0; // spent in the model, accumulated over the steps with EKF_BENCHMARK
+
+private:
+    // inputs of a step of the filter, to run it again when a delayed measurement comes in, and its estimate
+    typedef struct {
+        IMU_sample sample;
+        float dt; // [s]
+        uint8_t observed; // observables updated at the step
+        float z[Mobs];
+        Vector<Nsta> x;
+        Matrix<Nsta, Nsta> P;
+        Quaternion attitude;
+    } Step;
+
+    GpsEkf ekf;
+    float Q_dt = 0; // [s] step which ekf.Q is scaled to
+
+    /*
+     * Body to navigation frame rotation, propagated with the gyroscopes. The attitude states
+     * of the filter, x[6..8], are the small angles by which it is off: they are folded into
+     * it after every step, then zeroed.
+     */
+    Quaternion attitude = Quaternion::identity();
+
+    // ring of the last steps, numbered from the first one
+    Step history[EKF_HISTORY_LENGTH];
+    uint32_t step_count = 0;
+
+    // measurements of the coming step, and first step to run again
+    uint8_t observed = 0;
+    float z[Mobs] = { 0 };
+    uint32_t replay_from = 0;
+    uint32_t replayed_count = 0;
+
+    Step & history_step(uint32_t n) { return history[n % EKF_HISTORY_LENGTH]; }
+    uint32_t step_of(uint32_t timestamp);
+    void model(const Step & step);
+    int filter_step(const Step & step);
+    void end_step(Step & step);
+    void replay(uint32_t from);
+};
+
+#endif /* KALMAN_GPS_ESTIMATOR_H_ */
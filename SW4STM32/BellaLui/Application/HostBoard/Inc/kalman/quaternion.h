@@ -0,0 +1,70 @@
+/*
+ * quaternion.h
+ *
+ * Unit quaternions for the attitude of the rocket, in single precision and without any
+ * trigonometric function: the Cortex-M4F only has hardware support for float
+ * multiply-adds, divisions and square roots.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef KALMAN_QUATERNION_H_
+#define KALMAN_QUATERNION_H_
+
+#include <math.h>
+
+struct Quaternion
+{
+    float w, x, y, z;
+
+    static Quaternion identity() { return { 1, 0, 0, 0 }; }
+
+    /*
+     * Rotation by the angle vector (tx, ty, tz) [rad], to second order in its norm:
+     * accurate for the small rotations of one filter step.
+     */
+    static Quaternion from_rotation_vector(float tx, float ty, float tz)
+    {
+        const float t2 = tx*tx + ty*ty + tz*tz;
+        const float s = 0.5f - t2 * (1.0f/48);
+
+        return Quaternion { 1 - t2 * (1.0f/8), s*tx, s*ty, s*tz }.normalized();
+    }
+
+    /* Hamilton product: the rotation matrix of the product is the product of the rotation matrices */
+    Quaternion operator*(const Quaternion & q) const
+    {
+        return {
+            w*q.w - x*q.x - y*q.y - z*q.z,
+            w*q.x + x*q.w + y*q.z - z*q.y,
+            w*q.y - x*q.z + y*q.w + z*q.x,
+            w*q.z + x*q.y - y*q.x + z*q.w
+        };
+    }
+
+    Quaternion normalized() const
+    {
+        const float n = 1 / sqrtf(w*w + x*x + y*y + z*z);
+        return { w*n, x*n, y*n, z*n };
+    }
+
+    /* matrix of the rotation, body to navigation frame for an attitude */
+    void rotation(float R[3][3]) const
+    {
+        const float xx = x*x, yy = y*y, zz = z*z;
+        const float xy = x*y, xz = x*z, yz = y*z;
+        const float wx = w*x, wy = w*y, wz = w*z;
+
+        R[0][0] = 1 - 2*(yy + zz);
+        R[0][1] = 2*(xy - wz);
+        R[0][2] = 2*(xz + wy);
+        R[1][0] = 2*(xy + wz);
+        R[1][1] = 1 - 2*(xx + zz);
+        R[1][2] = 2*(yz - wx);
+        R[2][0] = 2*(xz - wy);
+        R[2][1] = 2*(yz + wx);
+        R[2][2] = 1 - 2*(xx + yy);
+    }
+};
+
+#endif /* KALMAN_QUATERNION_H_ */
@@ -7,10 +7,13 @@
  */
 
 #ifndef TINY_EKF_H_
-#define TINY_EFK_H_
+#define TINY_EKF_H_
 #include "../../../HostBoard/Inc/Misc/datastructs.h"
 #include <stdbool.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 /**
   * Initializes an EKF structure.
@@ -35,8 +38,6 @@
         float F[N][N];  // Jacobian of process model
         float H[M][N];  // Jacobian of measurement model
 
-        float Ht[N][M]; // transpose of measurement Jacobian
-        float Ft[N][N]; // transpose of process Jacobian
         float Pp[N][N]; // P, post-prediction, pre-update
 
         float fx[N];   // output of user defined f() state-transition function
@@ -58,8 +59,6 @@ enum Kalman_state {
 
 void mat_exp(float F[9][9], float PHI[9][9], int n);
 
-void updateP(float Pmatrix[9][9], float F[9][9], float Q[9][9]);
-
 void ekf_init(void * ekf, int n, int m);
 
 void TK_kalman();
@@ -77,4 +76,8 @@ bool kalman_handleBaroData(BARO_data data);
   */
 int ekf_step(void * ekf, float * z);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
@@ -8,8 +8,8 @@
  * MIT License
  */
 
-#ifndef TINY_EKF_H_
-#define TINY_EFK_H_
+#ifndef TINYEKF_CONFIG_H_
+#define TINYEKF_CONFIG_H_
 
 /* states */
 #define Nsta 9
@@ -33,8 +33,6 @@ typedef struct {
     float F[Nsta][Nsta];  /* Jacobian of process model */
     float H[Mobs][Nsta];  /* Jacobian of measurement model */
 
-    float Ht[Nsta][Mobs]; /* transpose of measurement Jacobian */
-    float Ft[Nsta][Nsta]; /* transpose of process Jacobian */
     float Pp[Nsta][Nsta]; /* P, post-prediction, pre-update */
 
     float fx[Nsta];   /* output of user defined f() state-transition function */
@@ -32,7 +32,7 @@ enum states
 
 enum warning
 {
-	EVENT, WARNING_MOTOR_PRESSURE
+	EVENT, WARNING_MOTOR_PRESSURE, WARNING_SENSOR_HEALTH
 };
 
 volatile uint32_t flight_status;
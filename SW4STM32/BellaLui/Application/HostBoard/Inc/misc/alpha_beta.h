@@ -0,0 +1,27 @@
+/*
+ * alpha_beta.h
+ *
+ * Altitude and vertical speed filter of TK_state_estimation, as a step function of its
+ * state and of one baro sample, free of any RTOS call.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef MISC_ALPHA_BETA_H_
+#define MISC_ALPHA_BETA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct
+{
+  float altitude; // [m]
+  float speed; // [m/s]
+  uint32_t last_timestamp; // [ms]
+  bool initialised;
+} AlphaBetaState;
+
+void alpha_beta_init (AlphaBetaState* state);
+void alpha_beta_step (AlphaBetaState* state, float altitude, uint32_t timestamp);
+
+#endif /* MISC_ALPHA_BETA_H_ */
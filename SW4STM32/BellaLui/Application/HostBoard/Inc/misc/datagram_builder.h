@@ -12,6 +12,8 @@
 #include <stm32f4xx_hal.h>
 #include "../../../HostBoard/Inc/Misc/datastructs.h"
 
+#define DATAGRAM_MALLOC_SIZE 64 // same malloc size for all datagrams, otherwise it fragments the memory
+
 #if defined __GNUC__
 #define bswap16(x) __builtin_bswap16(x)
 #else
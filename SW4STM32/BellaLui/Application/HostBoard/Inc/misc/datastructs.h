@@ -17,6 +17,8 @@
 typedef float float32_t;
 typedef double float64_t;
 
+#define CAN_TIMESTAMP_MASK (0x00FFFFFF) // time stamps only keep 24 bits on the CAN bus
+
 typedef struct
 {
   float32_t x, y, z;
@@ -27,6 +29,7 @@ typedef struct
   float3D acceleration;
   float3D eulerAngles;
   float32_t temperatureC;
+  uint32_t timestamp; // [ms] time of the sample
 } IMU_data;
 
 typedef struct
@@ -36,6 +39,7 @@ typedef struct
   float32_t altitude;
   float32_t base_pressure;
   float32_t base_altitude;
+  uint32_t timestamp; // [ms] time of the sample
 } BARO_data;
 
 typedef struct
@@ -51,6 +55,7 @@ typedef struct
   float32_t lon; // deg
   int32_t altitude; // cm
   uint8_t sats;
+  uint32_t timestamp; // [ms] time of the fix
 } GPS_data;
 
 
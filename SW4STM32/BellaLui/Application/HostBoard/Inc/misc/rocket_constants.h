@@ -27,6 +27,7 @@
 #define ROCKET_CST_MIN_TRIG_AGL 300 // min altitude above ground level to allow apogee detection [m]
 #define ROCKET_CST_MOTOR_BURNTIME 5600 // motor burn time [ms]
 #define ROCKET_CST_REC_SECONDARY_ALT 150 // altitude of secondary recovery event [m]
+#define ROCKET_CST_TARGET_APOGEE 3048 // apogee above ground level aimed at by the airbrakes [m]
 #define LIFTOFF_DETECTION_DELAY 500 // delay to trigger the liftoff event [ms]
 
 /*
@@ -47,7 +48,7 @@
 #define CALIB_BARO_BUFFER_SIZE 50 // Number of measurement values taken by the calibration routine to evaluate intial altitude
 
 
-#define ADJUSTED_SEA_LEVEL_PRESSURE 1018.6
+#define ADJUSTED_SEA_LEVEL_PRESSURE 1018.6f
 #define AIR_DENSITY 1.204
 
 
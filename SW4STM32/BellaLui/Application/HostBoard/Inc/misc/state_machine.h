@@ -10,6 +10,7 @@
 
 void TK_state_machine (void const * argument);
 void TK_state_estimation ();
+void state_estimation_notifyBaro ();
 
 
 #endif /* MISC_STATE_MACHINE_H_ */
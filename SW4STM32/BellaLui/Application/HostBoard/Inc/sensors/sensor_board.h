@@ -11,11 +11,37 @@
 #include <math.h>
 #include <misc/rocket_constants.h>
 
+void sensor_board_init();
 void TK_sensor_board(void const * argument);
+void TK_sensor_probe(void const * argument);
 
-inline float altitudeFromPressure(float pressure_hPa)
+#define ALTITUDE_TABLE_MIN_HPA 300
+#define ALTITUDE_TABLE_MAX_HPA 1100
+#define ALTITUDE_TABLE_STEP_HPA 4
+#define ALTITUDE_TABLE_SIZE ((ALTITUDE_TABLE_MAX_HPA - ALTITUDE_TABLE_MIN_HPA) / ALTITUDE_TABLE_STEP_HPA + 1)
+
+extern const float altitude_table[ALTITUDE_TABLE_SIZE]; // see altitude_table.c
+
+static inline float altitudeFromPressureReference(float pressure_hPa)
 {
-	return 44330 * (1.0 - pow (pressure_hPa / ADJUSTED_SEA_LEVEL_PRESSURE, 0.1903));
+	return 44330.0f * (1.0f - powf (pressure_hPa / ADJUSTED_SEA_LEVEL_PRESSURE, 0.1903f));
+}
+
+/*
+ * Linear interpolation in altitude_table, within 0.12 m of the formula from 300 to 1100 hPa
+ * (0.03 m above 700 hPa). Other pressures go through the formula.
+ */
+static inline float altitudeFromPressure(float pressure_hPa)
+{
+	if (!(pressure_hPa >= ALTITUDE_TABLE_MIN_HPA && pressure_hPa < ALTITUDE_TABLE_MAX_HPA)) {
+		return altitudeFromPressureReference(pressure_hPa);
+	}
+
+	float t = (pressure_hPa - ALTITUDE_TABLE_MIN_HPA) * (1.0f / ALTITUDE_TABLE_STEP_HPA);
+	int i = (int) t;
+	float a = altitude_table[i];
+
+	return a + (t - i) * (altitude_table[i + 1] - a);
 }
 
 #endif /* SENSORS_SENSOR_BOARD_H_ */
@@ -0,0 +1,60 @@
+/*
+ * sensor_health.h
+ *
+ * Health of each sensor of the sensor board, kept across the acquisition cycles:
+ *
+ *  - good: acquired, and trusted until it fails or is rejected by the vote
+ *  - suspect: still acquired, excluded after HEALTH_EXCLUDE_FAULTS faulty cycles, good
+ *    again after HEALTH_RECOVER_PASSES faultless cycles in a row
+ *  - excluded: not acquired any more, re-initialised once its probe interval is over
+ *  - reprobing: being re-initialised, suspect if it succeeds and excluded otherwise
+ *
+ * The probe interval doubles at each exclusion until the sensor is good again: a flaky
+ * sensor is re-admitted less and less often.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef SENSORS_SENSOR_HEALTH_H_
+#define SENSORS_SENSOR_HEALTH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define HEALTH_EXCLUDE_FAULTS 10 // faulty cycles of a suspect sensor, 100 ms at 100 Hz
+#define HEALTH_RECOVER_PASSES 100 // faultless cycles in a row of a suspect sensor, 1 s at 100 Hz
+#define HEALTH_PROBE_INTERVAL_MS 1000 // [ms] from the first exclusion to the re-initialisation
+#define HEALTH_PROBE_INTERVAL_MAX_MS 32000 // [ms]
+#define HEALTH_BITS 2 // per sensor in the packed report
+
+enum Sensor_health {
+	SENSOR_HEALTH_GOOD, SENSOR_HEALTH_SUSPECT, SENSOR_HEALTH_EXCLUDED, SENSOR_HEALTH_REPROBING
+};
+
+typedef struct {
+	enum Sensor_health state;
+	uint8_t faults; // since the sensor became suspect
+	uint8_t passes; // in a row
+	uint32_t excluded_at; // [ms]
+	uint32_t probe_interval_ms;
+} Sensor_health_tracker;
+
+// never initialised: reprobing at once
+void health_init(Sensor_health_tracker* h);
+
+// good or suspect
+bool health_isAcquired(const Sensor_health_tracker* h);
+
+// after each cycle in which the sensor was acquired
+void health_update(Sensor_health_tracker* h, bool fault, uint32_t now);
+
+// true when an excluded sensor is due for a re-initialisation, which it is set reprobing for
+bool health_probeDue(Sensor_health_tracker* h, uint32_t now);
+
+// outcome of the re-initialisation of a reprobing sensor
+void health_probed(Sensor_health_tracker* h, bool success, uint32_t now);
+
+// the states of count sensors, HEALTH_BITS each from the least significant bits
+uint32_t health_pack(const Sensor_health_tracker* h, uint8_t count);
+
+#endif /* SENSORS_SENSOR_HEALTH_H_ */
@@ -0,0 +1,48 @@
+/*
+ * sensor_i2c.h
+ *
+ * Transactions with the sensors of the sensor board, on I2C3 for sensors 0 and 1 and on
+ * FMPI2C1 for sensors 2 and 3. The transfer runs on DMA or interrupts while the calling
+ * task waits for its completion: the other tasks keep running in the meantime, and a
+ * transaction can run on each bus at the same time.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef SENSORS_SENSOR_I2C_H_
+#define SENSORS_SENSOR_I2C_H_
+
+#include <stdint.h>
+
+#define SENSOR_I2C_TIMEOUT_MS 5 // [ms] to complete a transaction, 18 bytes take 2 ms at 100 kHz
+
+enum Sensor_i2c_bus {
+	SENSOR_I2C_BUS_I2C3, SENSOR_I2C_BUS_FMPI2C1, SENSOR_I2C_BUSES
+};
+
+// before the scheduler starts
+void sensor_i2c_init();
+
+enum Sensor_i2c_bus sensor_i2c_bus(uint8_t sensor_id);
+
+/*
+ * Reads or writes len bytes from the register reg_addr of the device dev_id on the bus of
+ * sensor_id, blocking the calling task only. Returns the HAL status of the transaction.
+ */
+int8_t sensor_i2c_read(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+int8_t sensor_i2c_write(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+
+/*
+ * The same read or write in three steps, to run one on each bus at once: the starts
+ * return as soon as the transfer is started, sensor_i2c_wait returns the bits
+ * (1 << bus) of the transactions of the mask that are over, or 0 after timeout_ms, and
+ * sensor_i2c_end returns the HAL status of the transaction and frees the bus.
+ * Every start must be followed by an end, which aborts a transaction not over yet, and
+ * data must be kept until then.
+ */
+int8_t sensor_i2c_start_read(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+int8_t sensor_i2c_start_write(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+uint32_t sensor_i2c_wait(uint32_t bus_mask, uint32_t timeout_ms);
+int8_t sensor_i2c_end(enum Sensor_i2c_bus bus);
+
+#endif /* SENSORS_SENSOR_I2C_H_ */
@@ -0,0 +1,43 @@
+/*
+ * sensor_sampling.h
+ *
+ * Sampling clock of the sensor board: TIM7 triggers each acquisition at a fixed period,
+ * and the trigger time stamps the samples. The period actually seen by the sensor board
+ * task is measured against the nominal one.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef SENSORS_SENSOR_SAMPLING_H_
+#define SENSORS_SENSOR_SAMPLING_H_
+
+#include <stdint.h>
+
+#define SAMPLING_PERIOD_US 10000 // 100 Hz
+#define SAMPLING_STATS_WINDOW 100 // periods per published statistics, one second
+
+typedef struct {
+	uint32_t timestamp; // [ms] HAL tick at the trigger
+	uint32_t missed; // triggers since the previous acquisition, not acquired
+} Sampling_trigger;
+
+typedef struct {
+	uint32_t periods;
+	int32_t period_min_us, period_max_us; // between the starts of two acquisitions
+	float period_jitter_us; // standard deviation of the period
+	uint32_t latency_max_us; // from the trigger to the start of the acquisition
+	uint32_t missed;
+} Sampling_stats;
+
+// before the scheduler starts
+void sampling_init();
+
+void sampling_start(uint32_t period_us);
+
+// blocks until the next trigger, which starts an acquisition
+void sampling_wait(Sampling_trigger* trigger);
+
+// statistics since the previous call
+void sampling_takeStats(Sampling_stats* stats);
+
+#endif /* SENSORS_SENSOR_SAMPLING_H_ */
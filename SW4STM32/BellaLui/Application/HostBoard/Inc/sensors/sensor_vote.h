@@ -0,0 +1,58 @@
+/*
+ * sensor_vote.h
+ *
+ * Redundancy of the sensor board: the value of each axis is voted among the sensors
+ * that measure it, whatever their number. A reading further from the median than
+ * VOTE_OUTLIER_COEF standard deviations, estimated by the median absolute deviation,
+ * is discarded and the others are averaged.
+ * The vectors of a sensor, like the acceleration and the rate of an IMU, are voted as a
+ * whole instead: a sensor off on one of them is discarded from all, once per cycle.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef SENSORS_SENSOR_VOTE_H_
+#define SENSORS_SENSOR_VOTE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define VOTE_MAX_SENSORS 8
+#define VOTE_OUTLIER_COEF 3.0f // coefficient for a 99 % confidence interval
+#define VOTE_MAD_TO_STD_DEV 1.4826f // standard deviation of a normal distribution per MAD
+#define VOTE_VECTOR_OUTLIER_COEF 3.37f // 99 % quantile of the distance of a 3D normal distribution, in standard deviations
+#define VOTE_MEDIAN_DISTANCE_TO_STD_DEV 0.650f // standard deviation per median distance, in 3D
+
+typedef struct {
+	float x, y, z;
+} Vote_vector;
+
+// one vector per sensor, in a structure of arrays
+typedef struct {
+	float x[VOTE_MAX_SENSORS];
+	float y[VOTE_MAX_SENSORS];
+	float z[VOTE_MAX_SENSORS];
+} Vote_vectors;
+
+/*
+ * values holds the axes of each sensor in a row: values[sensor * axes + axis]. Only the
+ * sensors flagged valid vote, and rejected flags those discarded on at least one axis.
+ * tolerance is the spread of each axis between healthy sensors, below which a
+ * reading is never discarded: sensors that agree exactly give no deviation at all.
+ * Returns the number of voting sensors. result is left unchanged when there is none,
+ * and is their average when there are two or less.
+ */
+uint8_t sensor_vote(const float* values, uint8_t sensors, uint8_t axes, const bool* valid,
+		const float* tolerance, float* result, bool* rejected);
+
+/*
+ * The same vote on the vectors of each kind of data, vectors[kind], for which result[kind]
+ * is the average of the sensors kept. Each sensor is scored by its distance to the
+ * median of each component, which catches a wrong norm as well as a wrong direction.
+ * The tolerance of each kind is positive, as a standard deviation per component.
+ * When all the sensors are discarded, the one closest to the medians is kept.
+ */
+uint8_t sensor_vote_vectors(const Vote_vectors* vectors, uint8_t kinds, uint8_t sensors, const bool* valid,
+		const float* tolerance, Vote_vector* result, bool* rejected);
+
+#endif /* SENSORS_SENSOR_VOTE_H_ */
@@ -0,0 +1,56 @@
+/*
+ * telemetry_store.h
+ *
+ * Store-and-forward of the downlink telemetry.
+ *
+ * Every telemetry datagram handed to the xBee queue is also kept in a ring of
+ * RocketFS files, indexed by its sequence number (the "packet number" field of the
+ * datagram). When the link comes back after a loss, the ground station sends a
+ * BACKFILL_REQUEST_PACKET with the range of sequence numbers it missed and the
+ * stored datagrams are sent again, unchanged, using only the room left in the xBee
+ * queue by the live telemetry.
+ *
+ * The ACK datagrams are numbered apart and never stored, so that the sequence numbers
+ * of the telemetry have no gap. They restart at every reset, so the ring is cleared
+ * at start-up: a reset in flight, a brown-out for instance, loses the backlog of the
+ * run before it, which the ground station can then no longer complete. Resuming the ring
+ * would need the numbering to go on from the last stored record before the first
+ * datagram is sent, while the file system is only mounted later by the heavy IO thread.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef STORAGE_TELEMETRY_STORE_H_
+#define STORAGE_TELEMETRY_STORE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define TELEMETRY_STORE_MAX_DATAGRAM_SIZE 64 // larger datagrams are not stored
+#define TELEMETRY_STORE_RECORD_SIZE (4 + 1 + TELEMETRY_STORE_MAX_DATAGRAM_SIZE) // seq | size | datagram
+
+#define TELEMETRY_STORE_STAGING_RECORDS 64 // records waiting in RAM for the store thread
+#define TELEMETRY_STORE_SEGMENTS 8
+#define TELEMETRY_STORE_SEGMENT_SIZE (256 * 1024) // bytes per file, the ring keeps about 30000 datagrams
+#define TELEMETRY_STORE_QUEUE_RESERVE 8 // xBee queue slots always left to the live telemetry
+
+typedef struct
+{
+	uint32_t stored; // datagrams written to the flash
+	uint32_t dropped; // datagrams lost because the staging buffer was full
+	uint32_t resent; // datagrams queued again for a backfill request
+} TelemetryStore_stats;
+
+void telemetry_store(uint32_t seq, const uint8_t* datagram, uint16_t size);
+void telemetry_store_request(uint32_t first_seq, uint32_t last_seq);
+TelemetryStore_stats telemetry_store_get_stats();
+void TK_telemetry_store(void const* args);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* STORAGE_TELEMETRY_STORE_H_ */
@@ -0,0 +1,47 @@
+/*
+ * fec.h
+ *
+ * Forward error correction of the downlink datagrams.
+ *
+ * Datagrams are gathered in groups of FEC_GROUP_SIZE. For every group,
+ * FEC_PARITY_COUNT parity datagrams (FEC_PACKET) are appended, computed with a
+ * systematic Reed-Solomon code over GF(2^8) interleaved byte-wise across the
+ * datagrams of the group: byte i of every datagram forms one RS(K+R, K) codeword.
+ * The ground station can therefore rebuild up to FEC_PARITY_COUNT lost datagrams
+ * per group (erasure decoding), while the data datagrams themselves are sent unchanged.
+ *
+ * Parity datagram layout:
+ *   type (1) | "EPFL" (4) | group (1) | parity index (1) | K (1) | columns (1)
+ *   | CRC16 of each member datagram (2 * K) | parity bytes (columns) | CRC16 (2)
+ *
+ * Column 0 of the code is the length of each member datagram, columns 1.. are its bytes
+ * (zero-padded up to the longest datagram of the group).
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef TELEMETRY_FEC_H_
+#define TELEMETRY_FEC_H_
+
+#include <stdint.h>
+
+#define FEC_GROUP_SIZE 8
+#define FEC_PARITY_COUNT 2
+#define FEC_MAX_DATAGRAM_SIZE 64 // larger datagrams are sent without protection
+
+#define FEC_HEADER_SIZE 9
+#define FEC_PARITY_MAX_SIZE (FEC_HEADER_SIZE + 2 * FEC_GROUP_SIZE + FEC_MAX_DATAGRAM_SIZE + 1 + 2)
+
+typedef struct
+{
+	uint32_t data_bytes; // bytes of protected datagrams
+	uint32_t parity_bytes; // bytes of parity datagrams
+	uint32_t groups; // completed groups
+} FEC_stats;
+
+void fec_init();
+uint8_t fec_add_datagram(const uint8_t* datagram, uint16_t size);
+uint16_t fec_build_parity(uint8_t index, uint8_t* buffer);
+FEC_stats fec_get_stats();
+
+#endif /* TELEMETRY_FEC_H_ */
@@ -8,6 +8,7 @@
 #define TELEMETRY_HANDLING_H_
 
 #include <stdbool.h>
+#include <threads.h>
 
 #include "../../../HostBoard/Inc/Misc/datastructs.h"
 
@@ -15,10 +16,15 @@ bool telemetry_sendGPSData(GPS_data data);
 bool telemetry_sendIMUData(IMU_data data);
 bool telemetry_sendBaroData(BARO_data data);
 bool telemetry_sendMotorPressureData(uint32_t pressure);
-bool telemetry_sendWarningPacketData(bool id, float value, uint8_t av_state);
+bool telemetry_sendWarningPacketData(uint8_t id, float value, uint8_t av_state);
 bool telemetry_sendABData();
 bool telemetry_receiveIgnitionPacket(uint8_t* rxPacketBuffer);
 bool telemetry_receiveOrderPacket(uint8_t* rxPacketBuffer);
+bool telemetry_receiveBackfillRequestPacket(uint8_t* rxPacketBuffer);
+
+#ifdef DATAGRAM_BENCHMARK
+void telemetry_benchmarkDatagrams();
+#endif
 
 
 
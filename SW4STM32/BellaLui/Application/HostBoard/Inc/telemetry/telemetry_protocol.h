@@ -8,12 +8,12 @@
 #define TELEMETRY_TELEMETRY_PROTOCOL_H_
 
 enum DatagramPayloadType {
-	GPS_PACKET = 0x01, STATUS_PACKET = 0x02, TELEMETRY_PACKET = 0x03, DEBUG_PACKET = 0x04, MOTOR_PACKET = 0x05, AIRBRAKES_PACKET = 0x06, ORDER_PACKET = 0x07, IGNITION_PACKET = 0x09
+	GPS_PACKET = 0x01, STATUS_PACKET = 0x02, TELEMETRY_PACKET = 0x03, DEBUG_PACKET = 0x04, MOTOR_PACKET = 0x05, AIRBRAKES_PACKET = 0x06, ORDER_PACKET = 0x07, IGNITION_PACKET = 0x09, ACK_PACKET = 0x0A, FEC_PACKET = 0x0B, BACKFILL_REQUEST_PACKET = 0x0C
 };
 
 enum  packetSize
 {
-	ORDER_PACKET_SIZE = 31, IGNITION_PACKET_SIZE = 31, TELEMETRY_PACKET_SIZE = 54
+	ORDER_PACKET_SIZE = 31, IGNITION_PACKET_SIZE = 31, TELEMETRY_PACKET_SIZE = 54, BACKFILL_REQUEST_PACKET_SIZE = 38
 };
 
 #define HEADER_PREAMBLE_FLAG 0x55
@@ -50,5 +50,7 @@ enum  packetSize
 #define AB_DATAGRAM_PAYLOAD_SIZE 4
 #define ORDER_DATAGRAM_PAYLOAD_SIZE 1
 #define IGNITION_DATAGRAM_PAYLOAD_SIZE 1
+#define ACK_DATAGRAM_PAYLOAD_SIZE 6
+#define BACKFILL_REQUEST_DATAGRAM_PAYLOAD_SIZE 8
 
 #endif /* TELEMETRY_TELEMETRY_PROTOCOL_H_ */
@@ -0,0 +1,53 @@
+/*
+ * uplink.h
+ *
+ * Reliable delivery of the ground-to-rocket commands (ORDER and IGNITION packets).
+ *
+ * The ground station numbers every command with a monotonic sequence number (the
+ * "packet number" field of the received datagram) and retransmits it until it
+ * receives the matching ACK datagram. On board, every command is acknowledged,
+ * even duplicates, but only executed the first time its sequence number is seen.
+ * Bulk telemetry does not go through this channel and stays best-effort.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef TELEMETRY_UPLINK_H_
+#define TELEMETRY_UPLINK_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Number of sequence numbers preceding the most recent one which are remembered.
+// Must not exceed the width of UplinkWindow.history.
+#define UPLINK_WINDOW_SIZE 32
+// Backwards jump of the sequence number taken for a restart of the ground station, whose
+// counter starts again from 0. Closer sequence numbers are late retransmissions.
+#define UPLINK_SESSION_GAP 1024
+
+enum UplinkVerdict
+{
+	UPLINK_NEW = 0, // first reception: execute and acknowledge
+	UPLINK_DUPLICATE = 1, // already executed: acknowledge again only
+	UPLINK_STALE = 2 // older than the window, within UPLINK_SESSION_GAP: acknowledge, never execute
+};
+
+typedef struct
+{
+	bool initialised;
+	uint32_t last_seq; // highest sequence number accepted so far
+	uint32_t history; // bit i set <=> (last_seq - 1 - i) was accepted
+} UplinkWindow;
+
+void uplink_reset(UplinkWindow* window);
+enum UplinkVerdict uplink_accept(UplinkWindow* window, uint32_t seq);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TELEMETRY_UPLINK_H_ */
@@ -31,6 +31,12 @@
 #define CAN_ID CAN_ID_MAIN_BOARD
 #define SENSOR
 #define KALMAN
+//#define EKF_BENCHMARK // logs the cycles spent in each EKF step
+//#define EKF_REGRESSION // checks each step of the EKF against tiny_ekf.c
+//#define NUMERICS_BENCHMARK // logs the cycles of the float sensor math against its former double version
+//#define BNO_BENCHMARK // logs the bytes and cycles of each IMU sample
+//#define BME_BENCHMARK // logs the bytes and cycles of each baro sample
+//#define ACQUISITION_BENCHMARK // logs the time to fetch all the sensors, both buses at once
 #define ROCKET_FSM
 #define FLASH_LOGGING
 #define BOARD_LED_R (0)
@@ -43,6 +49,9 @@
 #ifdef TELEMETRY_BOARD
 #define CAN_ID CAN_ID_TELEMETRY_BOARD
 #define XBEE
+#define XBEE_FEC // Reed-Solomon parity datagrams on the downlink, see telemetry/fec.h
+#define TELEMETRY_STORE // downlink backfill from the flash, see storage/telemetry_store.h
+//#define DATAGRAM_BENCHMARK // logs the cost of building a datagram at start-up
 //#define SDCARD
 #define BOARD_LED_R (80)
 #define BOARD_LED_G (50)
@@ -71,6 +80,10 @@
 #endif
 
 
+#if defined(TELEMETRY_STORE) && defined(FLASH_LOGGING)
+#error "TELEMETRY_STORE and FLASH_LOGGING cannot share the flash, enable only one of them"
+#endif
+
 #ifdef XBEE
 #include <telemetry/xbee.h>
 #endif
@@ -23,6 +23,7 @@ typedef float float32_t;
 #include <sensors/sensor_board.h>
 #include <misc/datastructs.h>
 #include <misc/Common.h>
+#include <misc/state_machine.h>
 #include <storage/sd_card.h>
 //#include <kalman/tiny_ekf.h>
 
@@ -32,14 +33,17 @@ typedef float float32_t;
 #define BUFFER_SIZE 128
 
 #define GPS_DEFAULT (-1.0)
+#define KALMAN_TIMEOUT_MS (100) // [ms] without a Kalman estimate before the airbrakes use TK_state_estimation
 
 IMU_data IMU_buffer[CIRC_BUFFER_SIZE];
 BARO_data BARO_buffer[CIRC_BUFFER_SIZE];
 
 float kalman_z  = 0;
 float kalman_vz = 0;
+uint32_t kalman_timestamp = 0; // [ms] arrival of the last DATA_ID_KALMAN_Z, 0 before the first one
 float motor_pressure = 0;
 int32_t ab_angle = 42;
+uint32_t sensor_health = UINT32_MAX; // last DATA_ID_SENSOR_HEALTH, none yet
 
 
 // wrapper to avoid fatal crashes when implementing redundancy
@@ -56,7 +60,7 @@ bool handleGPSData(GPS_data data) {
 #ifdef XBEE
 	return telemetry_sendGPSData(data);
 #elif defined(KALMAN)
-	if (data.lat < 1e3) {
+	if (data.lat < 1e3f) {
 		return kalman_handleGPSData(data);
 	}
 #endif
@@ -86,6 +90,7 @@ bool handleBaroData(BARO_data data) {
 
 	BARO_buffer[(++currentBaroSeqNumber) % CIRC_BUFFER_SIZE] = data;
 	currentBaroTimestamp = HAL_GetTick();
+	state_estimation_notifyBaro();
 
 #ifdef XBEE
 	return telemetry_handleBaroData(data);
@@ -113,13 +118,31 @@ bool handleMotorData(IMU_data data) {
 	return true;
 }
 
+#ifdef AB_CONTROL
+/*
+ * The airbrake board runs its own estimate on its baro, worse than the one of the Kalman
+ * filter but which does not depend on the CAN: it stands in while no Kalman frame comes.
+ */
+static inline bool kalman_lost() {
+	return kalman_timestamp == 0 || HAL_GetTick() - kalman_timestamp > KALMAN_TIMEOUT_MS;
+}
+#endif
+
 float can_getAltitude() {
-	//return altitude_estimate; // from TK_state_estimation
+#ifdef AB_CONTROL
+	if (kalman_lost()) {
+		return altitude_estimate; // from TK_state_estimation
+	}
+#endif
 	return kalman_z;
 }
 
 float can_getSpeed() {
-	//return air_speed_state_estimate; // from TK_state_estimation
+#ifdef AB_CONTROL
+	if (kalman_lost()) {
+		return air_speed_state_estimate; // from TK_state_estimation
+	}
+#endif
 	return kalman_vz;
 }
 
@@ -179,13 +202,14 @@ void TK_can_reader() {
 			switch(msg.id) {
 			case DATA_ID_PRESSURE:
 				baro[idx].pressure = ((float32_t) ((int32_t) msg.data)) / 100; // convert from cPa to hPa
+				baro[idx].timestamp = msg.timestamp;
 				new_baro[idx] = true; // only update when we get the pressure
 				break;
 			case DATA_ID_TEMPERATURE:
 				baro[idx].temperature = ((float32_t) ((int32_t) msg.data)) / 100; // from to cDegC in DegC
 				break;
 			case DATA_ID_CALIB_PRESSURE:
-				baro[idx].base_pressure = ((float32_t) ((int32_t) msg.data)) / 100; // from cPa to hPa
+				baro[idx].base_pressure = ((float32_t) ((int32_t) msg.data)) / 100; // from Pa to hPa
 				break;
 			case DATA_ID_ACCELERATION_X:
 				imu[idx].acceleration.x = ((float32_t) ((int32_t) msg.data)) / 1000; // convert from m-g to g
@@ -195,6 +219,7 @@ void TK_can_reader() {
 				break;
 			case DATA_ID_ACCELERATION_Z:
 				imu[idx].acceleration.z = ((float32_t) ((int32_t) msg.data)) / 1000;
+				imu[idx].timestamp = msg.timestamp;
 				new_imu[idx] = true;  // only update when we get IMU from Z
 				break;
 			case DATA_ID_GYRO_X:
@@ -206,24 +231,45 @@ void TK_can_reader() {
 			case DATA_ID_GYRO_Z:
 				imu[idx].eulerAngles.z = ((float32_t) ((int32_t) msg.data));
 				break;
+			case DATA_ID_SAMPLE_ACCEL_XY:
+				imu[idx].acceleration.x = ((float32_t) can_highHalf(msg.data)) / 1000; // convert from m-g to g
+				imu[idx].acceleration.y = ((float32_t) can_lowHalf(msg.data)) / 1000;
+				break;
+			case DATA_ID_SAMPLE_ACCEL_Z_GYRO_X:
+				imu[idx].acceleration.z = ((float32_t) can_highHalf(msg.data)) / 1000;
+				imu[idx].eulerAngles.x = ((float32_t) can_lowHalf(msg.data)); // keep in mrps
+				break;
+			case DATA_ID_SAMPLE_GYRO_YZ:
+				imu[idx].eulerAngles.y = ((float32_t) can_highHalf(msg.data));
+				imu[idx].eulerAngles.z = ((float32_t) can_lowHalf(msg.data));
+				imu[idx].timestamp = msg.timestamp;
+				new_imu[idx] = true; // last frame of the IMU sample
+				break;
+			case DATA_ID_SAMPLE_BARO:
+				baro[idx].pressure = ((float32_t) can_baroPressure(msg.data)) / 100; // from Pa to hPa
+				baro[idx].temperature = ((float32_t) can_baroTemperature(msg.data)) / 100; // from cDegC to DegC
+				baro[idx].timestamp = msg.timestamp;
+				new_baro[idx] = true;
+				break;
 			case DATA_ID_GPS_HDOP:
-				gps[idx].hdop = ((float32_t) ((int32_t) msg.data)) / 1e3; // from mm to m
+				gps[idx].hdop = ((float32_t) ((int32_t) msg.data)) / 1e3f; // from mm to m
 				if (!gps_fix[idx]) {
 					gps_fix[idx] = true;
 					total_gps_fixes++;
 				}
 				break;
 			case DATA_ID_GPS_LAT:
-				gps[idx].lat = ((float32_t) ((int32_t) msg.data))  / 1e6; // from udeg to deg
+				gps[idx].lat = ((float32_t) ((int32_t) msg.data))  / 1e6f; // from udeg to deg
 				break;
 			case DATA_ID_GPS_LONG:
-				gps[idx].lon = ((float32_t) ((int32_t) msg.data))  / 1e6; // from udeg to deg
+				gps[idx].lon = ((float32_t) ((int32_t) msg.data))  / 1e6f; // from udeg to deg
 				break;
 			case DATA_ID_GPS_ALTITUDE:
 				gps[idx].altitude = ((int32_t) msg.data) / 1; // keep in cm
 				break;
 			case DATA_ID_GPS_SATS:
 				gps[idx].sats = ((uint8_t) ((int32_t) msg.data));
+				gps[idx].timestamp = msg.timestamp;
 				new_gps[idx] = true;
 				break;
 			case DATA_ID_STATE:
@@ -232,15 +278,26 @@ void TK_can_reader() {
 #endif
 				break;
 			case DATA_ID_KALMAN_Z:
-				kalman_z = ((float32_t) ((int32_t) msg.data))/1e3; // from mm to m
+				kalman_z = ((float32_t) ((int32_t) msg.data))/1e3f; // from mm to m
+				kalman_timestamp = HAL_GetTick();
 				break;
 			case DATA_ID_KALMAN_VZ:
-				kalman_vz = ((float32_t) ((int32_t) msg.data))/1e3; // from mm/s to m/s
+				kalman_vz = ((float32_t) ((int32_t) msg.data))/1e3f; // from mm/s to m/s
 				break;
 			case DATA_ID_AB_INC:
 				ab_angle = ((int32_t) msg.data); // keep in deg
 				// new_ab = true;
 				break;
+			case DATA_ID_SENSOR_HEALTH:
+#ifdef XBEE
+				// sent down when it changes, the sensor board repeats it every second anyway
+				if (msg.data != sensor_health && telemetry_sendWarningPacketData(WARNING_SENSOR_HEALTH, (float) msg.data, currentState)) {
+					sensor_health = msg.data;
+				}
+#else
+				sensor_health = msg.data;
+#endif
+				break;
 			/*
 			case DATA_ID_MOTOR_PRESSURE:
 				motor_pressure = (float) msg.data;
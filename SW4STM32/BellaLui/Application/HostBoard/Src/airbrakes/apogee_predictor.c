@@ -0,0 +1,116 @@
+/*
+ * apogee_predictor.c
+ *
+ * Vertical flight with gravity and quadratic drag in an exponential atmosphere:
+ *   dv/dt = -g - k(opening) exp(-h / H) v^2
+ * The drag factors k were fitted to the trajectories of the SimData table
+ * (misc/lookup_table_shuriken.h), which this model reproduces within 6 m of apogee.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <math.h>
+
+#include <airbrakes/apogee_predictor.h>
+#include <misc/rocket_constants.h>
+
+#define GRAVITY (9.81f) // [m/s^2]
+#define DENSITY_SCALE_HEIGHT (8500.0f) // [m]
+
+#define DRAG_TABLE_STEP_DEG (50.0f)
+#define DRAG_TABLE_SIZE (5)
+
+// k [1/m] at the ground, for openings of 0 to 200 deg by steps of DRAG_TABLE_STEP_DEG
+static const float drag_table[DRAG_TABLE_SIZE] = { 1.2821e-4f, 1.4541e-4f, 1.6868e-4f, 1.9533e-4f, 2.2270e-4f };
+
+static float drag_factor (float opening_deg)
+{
+  float t = opening_deg / DRAG_TABLE_STEP_DEG;
+
+  if (t <= 0)
+    {
+      return drag_table[0];
+    }
+  if (t >= DRAG_TABLE_SIZE - 1)
+    {
+      return drag_table[DRAG_TABLE_SIZE - 1];
+    }
+
+  int i = (int) t;
+  return drag_table[i] + (t - i) * (drag_table[i + 1] - drag_table[i]);
+}
+
+/*
+ * Midpoint integration at a fixed step, stopped as soon as the speed turns negative:
+ * the last step is then cut at the apogee. The density is updated once per step, to
+ * first order at the midpoint.
+ */
+float apogee_predict (float altitude, float speed, float opening_deg)
+{
+  const float k = drag_factor (opening_deg);
+  const float dt = APOGEE_STEP_S;
+  float h = altitude, v = speed;
+
+  for (int i = 0; i < APOGEE_MAX_STEPS && v > 0; i++)
+    {
+      float drag = k * expf (-h / DENSITY_SCALE_HEIGHT);
+      float a = -GRAVITY - drag * v * v;
+
+      float vm = v + 0.5f * dt * a;
+      float drag_m = drag * (1 - 0.5f * dt * v / DENSITY_SCALE_HEIGHT);
+      float am = -GRAVITY - drag_m * vm * vm;
+
+      if (v + dt * am <= 0)
+        {
+          // the speed vanishes within the step, at a nearly constant deceleration
+          return h + v * v / (-2 * am);
+        }
+
+      h += dt * vm;
+      v += dt * am;
+    }
+
+  return h;
+}
+
+/*
+ * Opening [deg] for which the predicted apogee is ROCKET_CST_TARGET_APOGEE: closed if the
+ * rocket falls short of it, max_opening_deg if even this overshoots it, otherwise found
+ * by regula falsi between both, the apogee decreasing with the opening.
+ */
+float apogee_opening (float altitude, float speed, float max_opening_deg)
+{
+  // the drag no longer grows past the end of its table, the apogee is flat from there
+  float lo = 0, hi = fminf (max_opening_deg, (DRAG_TABLE_SIZE - 1) * DRAG_TABLE_STEP_DEG);
+  float err_lo = apogee_predict (altitude, speed, lo) - ROCKET_CST_TARGET_APOGEE;
+  float err_hi = apogee_predict (altitude, speed, hi) - ROCKET_CST_TARGET_APOGEE;
+
+  if (err_lo <= 0)
+    {
+      return lo;
+    }
+  if (err_hi >= 0)
+    {
+      return max_opening_deg;
+    }
+
+  float opening = lo;
+  for (int i = 0; i < APOGEE_SOLVER_ITERATIONS; i++)
+    {
+      opening = lo + (hi - lo) * err_lo / (err_lo - err_hi);
+      float err = apogee_predict (altitude, speed, opening) - ROCKET_CST_TARGET_APOGEE;
+
+      if (err > 0)
+        {
+          lo = opening;
+          err_lo = err;
+        }
+      else
+        {
+          hi = opening;
+          err_hi = err;
+        }
+    }
+
+  return opening;
+}
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 
 #include <misc/lookup_table_shuriken.h>
+#include <airbrakes/apogee_predictor.h>
 #include <CAN_communication.h>
 
 
@@ -230,9 +231,13 @@ float angle_tab (float altitude, float speed)
   }
 }
 
+/*
+ * Opening for which the apogee predicted from the current state is the target one,
+ * angle_tab being the same for the nominal trajectory only.
+ */
 void command_aerobrake_controller (float altitude, float speed)
 {
-  float opt_act_position_deg = angle_tab (altitude, speed);
+  float opt_act_position_deg = apogee_opening (altitude, speed, MAX_OPENING_DEG);
 
   int command_inc = deg2inc (opt_act_position_deg);
   motor_goto_position_inc(command_inc);
@@ -0,0 +1,229 @@
+/* gps_ekf: TinyEKF test case using You Chong's GPS example:
+ * 
+ *   http://www.mathworks.com/matlabcentral/fileexchange/31487-extended-kalman-filter-ekf--for-gps
+ * 
+ * Reads file gps.csv of satellite data and writes file ekf.csv of mean-subtracted estimated positions.
+ *
+ *
+ * References:
+ *
+ * 1. R G Brown, P Y C Hwang, "Introduction to random signals and applied 
+ * Kalman filtering : with MATLAB exercises and solutions",1996
+ *
+ * 2. Pratap Misra, Per Enge, "Global Positioning System Signals, 
+ * Measurements, and Performance(Second Edition)",2006
+ * 
+ * Copyright (C) 2015 Simon D. Levy
+ *
+ * MIT License
+ */
+
+#include <kalman/tiny_ekf.h>
+#include <kalman/gps_estimator.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <math.h>
+
+#include "cmsis_os.h"
+
+extern "C" {
+	#include "../../../HostBoard/Inc/CAN_communication.h"
+}
+#include "../../../HostBoard/Inc/Misc/datastructs.h"
+#include <threads.h>
+
+#ifdef EKF_BENCHMARK
+#include <debug/console.h>
+#include <debug/profiler.h>
+#endif
+
+#define EKF_IMU_QUEUE_LENGTH (16) // IMU samples waiting for the filter
+#define EKF_MEASUREMENT_QUEUE_LENGTH (8) // GPS and baro samples waiting for the filter
+#define EKF_IMU_TIMEOUT_MS (100) // [ms] without any IMU sample before reporting KALMAN_NO_IMU
+#define EKF_DEFAULT_DT_MS (10) // [ms] step assumed for the first sample and after a gap
+#define EKF_MAX_DT_MS (100) // [ms] longer intervals between two samples are a gap in the data
+
+#define earth_radius (6378e3f)
+
+float rad2deg(float deg) {
+	return deg*3.14f/180;
+}
+
+static QueueHandle_t imuQueue = NULL;
+static QueueHandle_t measurementQueue = NULL;
+static volatile uint32_t imu_dropped = 0;
+static volatile uint32_t measurements_dropped = 0;
+
+bool GPS_init = false;
+float lat_init = 0;
+float lon_init = 0;
+
+/*
+ * Queues the measurement for the filter. Never blocks: when the filter lags behind,
+ * the measurement is dropped and counted.
+ */
+static bool queue_measurement(const Measurement& m) {
+	if (measurementQueue == NULL) {
+		return false; // filter not started yet, keep the sample pending
+	}
+
+	if (xQueueSend(measurementQueue, &m, 0) != pdPASS) {
+		measurements_dropped++;
+	}
+
+	return true;
+}
+
+bool kalman_handleGPSData(GPS_data gps) {
+	/*
+	if (!GPS_init) {
+		lat_init = gps.lat;
+		lon_init = gps.lon;
+		GPS_init = true;
+	}
+
+	Measurement m = { OBSERVED_GPS, { 0 }, gps.timestamp };
+	m.z[0] = 0 * rad2deg(gps.lat-lat_init) * earth_radius; // x gps
+	m.z[1] = 0 * rad2deg(gps.lon-lon_init) * earth_radius / cosf(rad2deg(lat_init)); // y gps
+	m.z[2] = 0 * ((float) gps.altitude)/100; // z gps, from cm to m
+	return queue_measurement(m);
+	*/
+	return true;
+}
+
+/*
+ * Queues the sample for a prediction step of the filter.
+ * Never blocks: when the filter lags behind, the sample is dropped and counted.
+ */
+bool kalman_handleIMUData(IMU_data imu) {
+	IMU_sample sample;
+
+	sample.IMUb[0] = imu.acceleration.x * 9.81f;
+	sample.IMUb[1] = imu.acceleration.y * 9.81f;
+	sample.IMUb[2] = imu.acceleration.z * 9.81f;
+	sample.IMUb[3] = imu.eulerAngles.x / 1000; // actually rotation speed not eulerAngles, from mrad/s
+	sample.IMUb[4] = imu.eulerAngles.y / 1000;
+	sample.IMUb[5] = imu.eulerAngles.z / 1000;
+	sample.timestamp = imu.timestamp;
+
+	if (imuQueue == NULL) {
+		return false; // filter not started yet, keep the sample pending
+	}
+
+	if (xQueueSend(imuQueue, &sample, 0) != pdPASS) {
+		imu_dropped++;
+	}
+
+	return true;
+}
+
+bool kalman_handleBaroData(BARO_data data) {
+	Measurement m = { OBSERVED_BARO, { 0 }, data.timestamp };
+	m.z[3] = data.altitude - data.base_altitude;
+	return queue_measurement(m);
+}
+
+
+void TK_kalman() {
+	// Matrices start zeroed, off the thread stack
+	static GpsEstimator estimator;
+
+	// Do local initialization
+	estimator.init();
+
+
+	imuQueue = xQueueCreate(EKF_IMU_QUEUE_LENGTH, sizeof(IMU_sample));
+	measurementQueue = xQueueCreate(EKF_MEASUREMENT_QUEUE_LENGTH, sizeof(Measurement));
+
+	IMU_sample sample;
+	Measurement measurement;
+
+	bool first_sample = true;
+	uint32_t last_timestamp = 0;
+	uint32_t dropped = 0;
+	uint32_t late_measurements = 0;
+	uint32_t iter = 0;
+	uint8_t rocket_state = can_getState();
+	enum Kalman_state kalman_state = KALMAN_INIT;
+
+#ifdef EKF_BENCHMARK
+	uint32_t step_cycles_total = 0, step_cycles_max = 0, replayed_max = 0;
+	profiler_init();
+#endif
+
+
+	while (1) {
+		rocket_state = can_getState();
+
+		// one prediction per IMU sample, over the time elapsed since the previous one
+		if (xQueueReceive(imuQueue, &sample, pdMS_TO_TICKS(EKF_IMU_TIMEOUT_MS)) == pdPASS) {
+			uint32_t dt_ms = (sample.timestamp - last_timestamp) & CAN_TIMESTAMP_MASK;
+
+			if (first_sample || dt_ms > EKF_MAX_DT_MS) {
+				dt_ms = EKF_DEFAULT_DT_MS;
+			}
+			first_sample = false;
+			last_timestamp = sample.timestamp;
+
+			// samples dropped since the last step mean the filter cannot keep up
+			kalman_state = (imu_dropped + measurements_dropped != dropped) ? KALMAN_OVERRUN : KALMAN_OK;
+			dropped = imu_dropped + measurements_dropped;
+
+#ifdef EKF_BENCHMARK
+			uint32_t step_start = profiler_cycles();
+#endif
+
+			while (xQueueReceive(measurementQueue, &measurement, 0) == pdPASS) {
+				if (!estimator.add(measurement)) {
+					late_measurements++;
+					continue;
+				}
+
+				if (measurement.observed & OBSERVED_GPS) {
+					can_setFrame((int32_t) (1000 * measurement.z[0]), 51, HAL_GetTick());
+					can_setFrame((int32_t) (1000 * measurement.z[1]), 52, HAL_GetTick());
+				}
+			}
+
+			estimator.step(sample, dt_ms / 1e3f);
+
+#ifdef EKF_BENCHMARK
+			uint32_t step_cycles = profiler_cycles() - step_start;
+
+			step_cycles_total += step_cycles;
+			if (step_cycles > step_cycles_max) step_cycles_max = step_cycles;
+			if (estimator.replayed() > replayed_max) replayed_max = estimator.replayed();
+			if ((iter + 1) % 100 == 0) {
+				rocket_log("EKF step: %ld cycles average, %ld max, %ld multiply-accumulates (%ld dense)\n", step_cycles_total / 100,
+						step_cycles_max, estimator.macs(), GpsEkf::DENSE_MACS);
+				rocket_log("EKF model: %ld cycles average\n", estimator.model_cycles / 100);
+				rocket_log("EKF history: %ld steps replayed at most, %ld measurements too late\n", replayed_max, late_measurements);
+				estimator.model_cycles = 0;
+				step_cycles_total = 0;
+				step_cycles_max = 0;
+				replayed_max = 0;
+			}
+#endif
+			iter++;
+
+
+			//send estimate to the CAN
+			//can_setFrame((int32_t) (1000 * estimator.state()[0]), DATA_ID_KALMAN_X, HAL_GetTick());
+			//can_setFrame((int32_t) (1000 * estimator.state()[1]), DATA_ID_KALMAN_Y, HAL_GetTick());
+			can_setFrame((int32_t) (1000 * estimator.state()[2]), DATA_ID_KALMAN_Z, HAL_GetTick());
+			//can_setFrame((int32_t) (1000 * estimator.state()[3]), DATA_ID_KALMAN_VX, HAL_GetTick());
+			//can_setFrame((int32_t) (1000 * estimator.state()[4]), DATA_ID_KALMAN_VY, HAL_GetTick());
+			can_setFrame((int32_t) (1000 * estimator.state()[5]), DATA_ID_KALMAN_VZ, HAL_GetTick());
+			//can_setFrame((int32_t) (180 / 3.14 * estimator.state()[6]), DATA_ID_KALMAN_ROLL, HAL_GetTick());
+			//can_setFrame((int32_t) (180 / 3.14 * estimator.state()[7]), DATA_ID_KALMAN_PITCH, HAL_GetTick());
+			//can_setFrame((int32_t) (180 / 3.14 * estimator.state()[8]), DATA_ID_KALMAN_YAW, HAL_GetTick());
+		} else {
+			// no IMU data available :sadface:
+			kalman_state = KALMAN_NO_IMU;
+		}
+
+		can_setFrame(kalman_state, DATA_ID_KALMAN_STATE, HAL_GetTick());
+	}
+}
@@ -0,0 +1,349 @@
+/*
+ * gps_estimator.cpp
+ *
+ * Model and step sequencing of the navigation filter, see gps_ekf.cpp for the
+ * references of the model.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <kalman/gps_estimator.h>
+#include <kalman/tiny_ekf.h>
+#include <string.h>
+#include <math.h>
+
+#include <misc/datastructs.h>
+#include <threads.h>
+
+#ifdef EKF_REGRESSION
+#include <debug/console.h>
+#endif
+
+#ifdef EKF_BENCHMARK
+#include <debug/profiler.h>
+#endif
+
+
+#ifdef EKF_REGRESSION
+#define EKF_REGRESSION_TOLERANCE 1e-3f // relative error above which a step is reported as a mismatch
+
+static inline float relative_error(float reference, float value) {
+	return fabsf(reference - value) / fmaxf(fabsf(reference), 1e-6f);
+}
+
+/*
+ * Runs the same step with tiny_ekf.c, from the same inputs, and compares the outcome.
+ * The rows of H which were not observed are zeroed for tiny_ekf.c, so its batch update
+ * agrees with the sequential one up to rounding.
+ */
+static void regression_check(const GpsEkf& ekf, const GpsEkf& before, uint8_t observed, const float* z_step, int status) {
+	static ekf_t reference;
+	static uint32_t steps = 0, mismatches = 0;
+	static float max_error_x = 0, max_error_P = 0;
+
+	ekf_init(&reference, Nsta, Mobs);
+	memcpy(reference.x, before.x.v, sizeof(reference.x));
+	memcpy(reference.P, before.P.m, sizeof(reference.P));
+	memcpy(reference.Q, before.Q.m, sizeof(reference.Q));
+	memcpy(reference.R, before.R.m, sizeof(reference.R));
+	memcpy(reference.F, before.F.m, sizeof(reference.F));
+	for (int r = 0; r < Mobs; r++)
+		for (int j = 0; j < Nsta; j++)
+			reference.H[r][j] = (observed & (1 << r)) ? before.H[r][j] : 0;
+	memcpy(reference.fx, before.fx.v, sizeof(reference.fx));
+	memcpy(reference.hx, before.hx.v, sizeof(reference.hx));
+
+	float z[Mobs];
+	memcpy(z, z_step, sizeof(z));
+
+	if (ekf_step(&reference, z) != status) {
+		mismatches++;
+	} else if (status == 0) {
+		float error_x = 0, error_P = 0;
+
+		for (int i = 0; i < Nsta; i++) {
+			error_x = fmaxf(error_x, relative_error(reference.x[i], ekf.x[i]));
+			for (int j = 0; j < Nsta; j++)
+				// relative to the standard deviations, the off-diagonal terms are often cancellations close to 0
+				error_P = fmaxf(error_P, fabsf(reference.P[i][j] - ekf.P[i][j])
+						/ fmaxf(sqrtf(fabsf(reference.P[i][i] * reference.P[j][j])), 1e-6f));
+		}
+
+		if (error_x > EKF_REGRESSION_TOLERANCE || error_P > EKF_REGRESSION_TOLERANCE) {
+			mismatches++;
+		}
+
+		max_error_x = fmaxf(max_error_x, error_x);
+		max_error_P = fmaxf(max_error_P, error_P);
+	}
+
+	if (++steps % 100 == 0) {
+		rocket_log("EKF regression: %ld steps, %ld mismatches, max relative error %e on x, %e on P\n", steps, mismatches,
+				(double) max_error_x, (double) max_error_P);
+	}
+}
+#endif
+
+/*
+ * Process noise tuned for a step of Q_TUNED_DT, see [1]. Its position and velocity blocks
+ * are those of a white acceleration noise, q T^3/3, q T^2/2 and q T, and the attitude one
+ * a random walk, q T: the step of the filter follows the IMU samples, so Q is scaled to
+ * each step by (dt / Q_TUNED_DT)^k, k = 3, 2 or 1 for these blocks.
+ */
+#define Q_TUNED_DT 0.02f // [s]
+/*const float Sf    = 36;
+ const float Sg    = 0.01;
+ const float sigma = 5;         // state transition variance
+ const float Qb[4] = {Sf*T+Sg*T*T*T/3, Sg*T*T/2, Sg*T*T/2, Sg*T};
+ const float Qxyz[4] = {sigma*sigma*T*T*T/3, sigma*sigma*T*T/2, sigma*sigma*T*T/2, sigma*sigma*T};*/
+
+static const float Q_TUNED[81] = { 1.3085e-08, 9.2466e-25, 6.6028e-26, 9.8168e-07,
+		6.9357e-23, 4.9523e-24, 0, 0, 0, -6.4641e-26, 1.3083e-08,
+		-3.9941e-25, -4.8495e-24, 9.8132e-07, -2.9957e-23, 0, 0, 0,
+		7.9888e-25, -5.9826e-25, 1.3081e-08, 5.9934e-23, -4.4875e-23,
+		9.8116e-07, 0, 0, 0, .8168e-07, 6.937e-23, 4.9536e-24, 9.8168e-05,
+		6.9363e-21, 4.9529e-22, 0, 0, 0, -4.8486e-24, 9.8132e-07,
+		-2.996e-23, -4.849e-22, 9.8132e-05, -2.9959e-21, 0, 0, 0,
+		5.9918e-23, -4.4872e-23, 9.8116e-07, 5.9926e-21, -4.4874e-21,
+		9.8116e-05, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0.0002, 1.4035e-20,
+		8.6736e-21, 0, 0, 0, 0, 0, 0, 2.4938e-21, 0.0002, 0, 0, 0, 0, 0, 0,
+		0, 9.5501e-21, -1.2369e-20, 0.0002 };
+
+static inline bool is_position(int i) {
+	return i < 3;
+}
+
+// true if time stamp a comes after b, on the 24 bits kept by the CAN bus
+static inline bool later(uint32_t a, uint32_t b) {
+	uint32_t d = (a - b) & CAN_TIMESTAMP_MASK;
+	return d != 0 && d < (CAN_TIMESTAMP_MASK >> 1);
+}
+
+static inline void add_measurement(uint8_t& observed, float* z, const Measurement& m) {
+	for (int r = 0; r < Mobs; r++) {
+		if (m.observed & (1 << r)) z[r] = m.z[r];
+	}
+	observed |= m.observed;
+}
+
+void GpsEstimator::init() {
+	int i;
+	for (i = 0; i < 9; i++)
+		ekf.x[i] = 0;
+	Q_dt = 0; // Q is scaled to the step by the first model()
+
+	// initial covariances of state noise, measurement noise
+	float P0[9] = { 2, 2, 2, 1, 1, 1, 0.1, 0.1, 0.1 };
+	float R0[4] = { 20, 20, 10, 10 }; //accuracy of the GPS and baro
+
+	for (i = 0; i < 9; ++i)
+		ekf.P[i][i] = P0[i];
+
+	for (i = 0; i < 4; ++i)
+		ekf.R[i][i] = R0[i];
+
+	// GPS position and baro altitude, only the ones measured are updated
+	ekf.H[0][0] = 1;
+	ekf.H[1][1] = 1;
+	ekf.H[2][2] = 1;
+	ekf.H[3][2] = 1;
+
+	attitude = Quaternion::identity();
+	step_count = 0;
+	observed = 0;
+	replay_from = 0;
+	replayed_count = 0;
+}
+
+/*
+ * Number of the step a measurement is fused at: the first step at or after its time stamp,
+ * step_count for the coming one. Returns 0 if the measurement is older than the history,
+ * the estimate preceding its step being lost.
+ */
+uint32_t GpsEstimator::step_of(uint32_t timestamp) {
+	uint32_t oldest = step_count > EKF_HISTORY_LENGTH ? step_count - EKF_HISTORY_LENGTH : 0;
+	uint32_t n = step_count;
+
+	while (n > oldest && !later(timestamp, history_step(n - 1).sample.timestamp)) {
+		n--;
+	}
+
+	return (n == oldest && n < step_count) ? 0 : n;
+}
+
+/*
+ * Measurements which arrived since the last step, without any the step is simple INS.
+ * The ones older than the last step are fused at their own time, running the
+ * following steps again, within the EKF_HISTORY_LENGTH last steps.
+ */
+bool GpsEstimator::add(const Measurement& m) {
+	uint32_t n = step_of(m.timestamp);
+
+	if (n == step_count) {
+		add_measurement(observed, z, m);
+	} else if (n == 0) {
+		return false;
+	} else {
+		add_measurement(history_step(n).observed, history_step(n).z, m);
+		if (n < replay_from) replay_from = n;
+	}
+
+	return true;
+}
+
+/*
+ * Fills fx, F and hx for the IMU sample of the step, from the current estimate, and
+ * propagates the attitude with the gyroscopes.
+ */
+void GpsEstimator::model(const Step& step) {
+	static float F11[9][9]; // zero but for the entries set below
+	const float* IMUb = step.sample.IMUb;
+	const float dt = step.dt;
+	float R[3][3];
+	float IMUm[3];
+
+	//getting the acceleration of the captor in the mapping frame IMUb to IMUm
+	attitude.rotation(R);
+
+	IMUm[0] = R[0][0] * IMUb[0] + R[0][1] * IMUb[1] + R[0][2] * IMUb[2];
+	IMUm[1] = R[1][0] * IMUb[0] + R[1][1] * IMUb[1] + R[1][2] * IMUb[2];
+	IMUm[2] = R[2][0] * IMUb[0] + R[2][1] * IMUb[1] + R[2][2] * IMUb[2] - 9.81f;
+
+	// rotation of the body during the step
+	attitude = (attitude * Quaternion::from_rotation_vector(IMUb[3] * dt, IMUb[4] * dt, IMUb[5] * dt)).normalized();
+
+	//fill fx, the attitude error only changes through the updates
+	ekf.fx[6] = ekf.x[6];
+	ekf.fx[7] = ekf.x[7];
+	ekf.fx[8] = ekf.x[8];
+	ekf.fx[3] = ekf.x[3] + IMUm[0] * dt;
+	ekf.fx[4] = ekf.x[4] + IMUm[1] * dt;
+	ekf.fx[5] = ekf.x[5] + IMUm[2] * dt;
+	ekf.fx[0] = ekf.x[0] + ekf.x[3] * dt;
+	ekf.fx[1] = ekf.x[1] + ekf.x[4] * dt;
+	ekf.fx[2] = ekf.x[2] + ekf.x[5] * dt;
+
+	//fill F
+	F11[0][3] = 1 * dt;
+	F11[1][4] = 1 * dt;
+	F11[2][5] = 1 * dt;
+	F11[3][7] = -IMUm[2] * dt;
+	F11[3][8] = IMUm[1] * dt;
+	F11[4][6] = IMUm[2] * dt;
+	F11[4][8] = -IMUm[0] * dt;
+	F11[5][6] = -IMUm[1] * dt;
+	F11[5][7] = IMUm[0] * dt;
+
+	mat_exp(F11, ekf.F.m, 9); //2nd order taylor, exact since F11^3 = 0
+
+	//scale Q to the step, only when its length changes
+	if (dt != Q_dt) {
+		const float r = dt / Q_TUNED_DT;
+		const float scale[4] = { 0, r, r * r, r * r * r };
+
+		for (int i = 0; i < 9; i++)
+			for (int j = 0; j < 9; j++)
+				ekf.Q[i][j] = Q_TUNED[i * 9 + j] * scale[1 + is_position(i) + is_position(j)];
+		Q_dt = dt;
+	}
+
+	//fill hx
+	ekf.hx[0] = ekf.fx[0];
+	ekf.hx[1] = ekf.fx[1];
+	ekf.hx[2] = ekf.fx[2];
+	ekf.hx[3] = ekf.fx[2];
+}
+
+/*
+ * Prediction, then one scalar update per observed measurement of the step.
+ * Returns 0 on success, 1 if an update was rejected.
+ */
+int GpsEstimator::filter_step(const Step& step) {
+	int status = 0;
+
+	ekf.predict();
+
+	for (int r = 0; r < Mobs; r++) {
+		if ((step.observed & (1 << r)) && !ekf.update(r, step.z[r])) {
+			status = 1;
+		}
+	}
+
+	return status;
+}
+
+/*
+ * Corrects the attitude by the error estimated by the filter, rotating it by -x[6..8]
+ * (the model takes the true rotation as (I - [x[6..8]]x) R), and keeps the estimate the
+ * next steps start from.
+ */
+void GpsEstimator::end_step(Step& step) {
+	attitude = (Quaternion::from_rotation_vector(-ekf.x[6], -ekf.x[7], -ekf.x[8]) * attitude).normalized();
+
+	ekf.x[6] = 0;
+	ekf.x[7] = 0;
+	ekf.x[8] = 0;
+
+	step.x = ekf.x;
+	step.P = ekf.P;
+	step.attitude = attitude;
+}
+
+/*
+ * Runs the steps from the given one to the last one again, starting over from the estimate
+ * preceding it, after delayed measurements were added to it.
+ */
+void GpsEstimator::replay(uint32_t from) {
+	ekf.x = history_step(from - 1).x;
+	ekf.P = history_step(from - 1).P;
+	attitude = history_step(from - 1).attitude;
+
+	for (uint32_t n = from; n < step_count; n++) {
+		Step& step = history_step(n);
+		model(step);
+		filter_step(step);
+		end_step(step);
+	}
+}
+
+int GpsEstimator::step(const IMU_sample& sample, float dt) {
+	replayed_count = step_count - replay_from;
+	if (replay_from < step_count) {
+		replay(replay_from);
+	}
+
+	// the slot of the oldest step, needed until now by the delayed measurements
+	Step& step = history_step(step_count);
+	step.sample = sample;
+	step.dt = dt;
+	step.observed = observed;
+	memcpy(step.z, z, sizeof(z));
+
+#ifdef EKF_BENCHMARK
+	uint32_t model_start = profiler_cycles();
+	model(step);
+	model_cycles += profiler_cycles() - model_start;
+#else
+	model(step);
+#endif
+
+#ifdef EKF_REGRESSION
+	static GpsEkf before;
+	before = ekf;
+#endif
+
+	int status = filter_step(step);
+
+#ifdef EKF_REGRESSION
+	regression_check(ekf, before, step.observed, step.z, status);
+#endif
+
+	end_step(step);
+	step_count++;
+
+	observed = 0;
+	memset(z, 0, sizeof(z));
+	replay_from = step_count;
+
+	return status;
+}
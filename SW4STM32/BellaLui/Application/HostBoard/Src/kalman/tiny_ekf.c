@@ -10,6 +10,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 
+#include <kalman/ekf_kernels.h>
+
 /* Cholesky-decomposition matrix-inversion code, adapated from
    http://jean-pierre.moreau.pagesperso-orange.fr/Cplus/choles_cpp.txt */
 
@@ -27,7 +29,7 @@ static int choldc1(float * a, float * p, int n) {
                 if (sum <= 0) {
                     return 1; /* error */
                 }
-                p[i] = sqrt(sum);
+                p[i] = sqrtf(sum);
             }
             else {
                 a[j*n+i] = sum / p[i];
@@ -112,37 +114,31 @@ static void dump(float * a, int m, int n, const char * fmt)
 #endif
 
 /* C <- A * B */
-static void mulmat(float * a, float * b, float * c, int arows, int acols, int bcols)
+static void mulmat(const float * restrict a, const float * restrict b, float * restrict c, int arows, int acols, int bcols)
 {
-    int i, j,l;
+    int i, j;
 
     for(i=0; i<arows; ++i)
-        for(j=0; j<bcols; ++j) {
-            c[i*bcols+j] = 0;
-            for(l=0; l<acols; ++l)
-                c[i*bcols+j] += a[i*acols+l] * b[l*bcols+j];
-        }
+        for(j=0; j<bcols; ++j)
+            c[i*bcols+j] = ekf_dot(a+i*acols, 1, b+j, bcols, acols);
 }
 
-static void mulvec(float * a, float * x, float * y, int m, int n)
+/* C <- A * B^T, B given as a brows x acols matrix */
+static void mulmat_t(const float * restrict a, const float * restrict b, float * restrict c, int arows, int acols, int brows)
 {
     int i, j;
 
-    for(i=0; i<m; ++i) {
-        y[i] = 0;
-        for(j=0; j<n; ++j)
-            y[i] += x[j] * a[i*n+j];
-    }
+    for(i=0; i<arows; ++i)
+        for(j=0; j<brows; ++j)
+            c[i*brows+j] = ekf_dot(a+i*acols, 1, b+j*acols, 1, acols);
 }
 
-static void transpose(float * a, float * at, int m, int n)
+static void mulvec(const float * restrict a, const float * restrict x, float * restrict y, int m, int n)
 {
-    int i,j;
+    int i;
 
     for(i=0; i<m; ++i)
-        for(j=0; j<n; ++j) {
-            at[j*m+i] = a[i*n+j];
-        }
+        y[i] = ekf_dot(a+i*n, 1, x, 1, n);
 }
 
 /* A <- A + B */
@@ -196,7 +192,7 @@ void mat_exp(float F[9][9], float PHI[9][9], int n)
         for(j=0; j<n; ++j) {
             PHI[i][j] = 0;
             for(l=0; l<n; ++l)
-                PHI[i][j] += F[i][l] * F[l][j] * 0.5;
+                PHI[i][j] += F[i][l] * F[l][j] * 0.5f;
         }
     for(i=0; i<n; i++)
         for(j=0; j<n; j++)
@@ -204,32 +200,6 @@ void mat_exp(float F[9][9], float PHI[9][9], int n)
     for(i=0; i<n; i++)
         PHI[i][i]+=1;
 }
-void updateP(float Pmatrix[9][9], float F[9][9], float Q[9][9])
-{
-    float tmp[9][9];
-    float Ft[9][9];
-    int n=9;
-    int i, j,l;
-    for(i=0; i<n; ++i)
-        for(j=0; j<n; ++j) {
-            tmp[i][j] = 0;
-            for(l=0; l<n; ++l)
-                tmp[i][j] += F[i][l]*Pmatrix[l][j];
-        }
-    for(i=0; i<n; ++i)
-        for(j=0; j<n; ++j) {
-            Ft[j][i] = F[i][j];
-        }
-    for(i=0; i<n; ++i)
-        for(j=0; j<n; ++j) {
-            Pmatrix[i][j] = 0;
-            for(l=0; l<n; ++l)
-                Pmatrix[i][j] += tmp[i][l] * Ft[l][j];
-        }
-    for(i=0; i<n; i++)
-        for(j=0; j<n; j++)
-            Pmatrix[i][j]+=Q[i][j];    
-}
 
 /* TinyEKF code ------------------------------------------------------------------- */
 
@@ -248,8 +218,6 @@ typedef struct {
     float * F;  /* Jacobian of process model */
     float * H;  /* Jacobian of measurement model */
 
-    float * Ht; /* transpose of measurement Jacobian */
-    float * Ft; /* transpose of process Jacobian */
     float * Pp; /* P, post-prediction, pre-update */
 
     float * fx;  /* output of user defined f() state-transition function */
@@ -286,10 +254,6 @@ static void unpack(void * v, ekf_t * ekf, int n, int m)
     dptr += n*n;
     ekf->H = dptr;
     dptr += m*n;
-    ekf->Ht = dptr;
-    dptr += n*m;
-    ekf->Ft = dptr;
-    dptr += n*n;
     ekf->Pp = dptr;
     dptr += n*n;
     ekf->fx = dptr;
@@ -344,15 +308,13 @@ int ekf_step(void * v, float * z)
  
     /* P_k = F_{k-1} P_{k-1} F^T_{k-1} + Q_{k-1} */
     mulmat(ekf.F, ekf.P, ekf.tmp0, n, n, n);
-    transpose(ekf.F, ekf.Ft, n, n);
-    mulmat(ekf.tmp0, ekf.Ft, ekf.Pp, n, n, n);
+    mulmat_t(ekf.tmp0, ekf.F, ekf.Pp, n, n, n);
     accum(ekf.Pp, ekf.Q, n, n);
 
     /* G_k = P_k H^T_k (H_k P_k H^T_k + R)^{-1} */
-    transpose(ekf.H, ekf.Ht, m, n);
-    mulmat(ekf.Pp, ekf.Ht, ekf.tmp1, n, n, m);
+    mulmat_t(ekf.Pp, ekf.H, ekf.tmp1, n, n, m);
     mulmat(ekf.H, ekf.Pp, ekf.tmp2, m, n, n);
-    mulmat(ekf.tmp2, ekf.Ht, ekf.tmp3, m, n, m);
+    mulmat_t(ekf.tmp2, ekf.H, ekf.tmp3, m, n, m);
     accum(ekf.tmp3, ekf.R, m, m);
     if (cholsl(ekf.tmp3, ekf.tmp4, ekf.tmp5, m)) return 1;
     mulmat(ekf.tmp1, ekf.tmp4, ekf.G, n, m, m);
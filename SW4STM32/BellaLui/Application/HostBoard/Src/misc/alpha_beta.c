@@ -0,0 +1,53 @@
+/*
+ * alpha_beta.c
+ *
+ * Alpha-beta filter on the baro altitude: the altitude is predicted at constant speed
+ * between two samples, then both are corrected by a fraction of the residual. The
+ * Benedict-Bordner beta keeps the speed noise low for the smoothing given by alpha.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <misc/alpha_beta.h>
+#include <misc/datastructs.h>
+
+#define ALPHA_BETA_ALPHA (0.3f)
+#define ALPHA_BETA_BETA (ALPHA_BETA_ALPHA * ALPHA_BETA_ALPHA / (2 - ALPHA_BETA_ALPHA))
+#define ALPHA_BETA_MAX_DT_MS (500) // [ms] longer intervals between two samples restart the filter
+
+void alpha_beta_init (AlphaBetaState* state)
+{
+  state->altitude = 0;
+  state->speed = 0;
+  state->last_timestamp = 0;
+  state->initialised = false;
+}
+
+void alpha_beta_step (AlphaBetaState* state, float altitude, uint32_t timestamp)
+{
+  uint32_t dt_ms = (timestamp - state->last_timestamp) & CAN_TIMESTAMP_MASK;
+
+  // a repeated time stamp brings no new information on the speed
+  if (state->initialised && dt_ms == 0)
+    {
+      return;
+    }
+
+  state->last_timestamp = timestamp;
+
+  if (!state->initialised || dt_ms > ALPHA_BETA_MAX_DT_MS)
+    {
+      state->altitude = altitude;
+      state->speed = 0;
+      state->initialised = true;
+      return;
+    }
+
+  float dt = dt_ms / 1000.0f;
+
+  state->altitude += state->speed * dt;
+
+  float residual = altitude - state->altitude;
+  state->altitude += ALPHA_BETA_ALPHA * residual;
+  state->speed += ALPHA_BETA_BETA * residual / dt;
+}
@@ -8,66 +8,60 @@
 #include <cmsis_os.h>
 #include <misc/Common.h>
 #include <misc/rocket_constants.h>
+#include <misc/state_machine.h>
+#include <misc/alpha_beta.h>
 #include "../../../HostBoard/Inc/CAN_communication.h"
 
 volatile float32_t air_speed_state_estimate, altitude_estimate;
-#define ALTITUDE_BUFFER_SIZE 8
 
-void TK_state_estimation ()
-{
-  float32_t altitude_buffer[ALTITUDE_BUFFER_SIZE][2];
-  uint8_t altitude_index = 0;
-  BARO_data baro;
+#define STATE_ESTIMATION_SIGNAL_BARO (0x01) // new baro sample in BARO_buffer
 
-  uint32_t lastBaroSeqNumber = 0;
+static osThreadId state_estimation_thread = NULL;
 
-  while (LIFTOFF_TIME == 0)
+/*
+ * Called by handleBaroData for each sample put in BARO_buffer,
+ * before the estimator is started too.
+ */
+void state_estimation_notifyBaro ()
+{
+  if (state_estimation_thread != NULL)
     {
-      if (lastBaroSeqNumber < currentBaroSeqNumber)
-        {
-          altitude_index++;
-          baro = BARO_buffer[currentBaroSeqNumber % CIRC_BUFFER_SIZE];
-          altitude_buffer[altitude_index % ALTITUDE_BUFFER_SIZE][0] = baro.altitude - baro.base_altitude;
-          altitude_buffer[altitude_index % ALTITUDE_BUFFER_SIZE][1] = currentBaroTimestamp;
-          lastBaroSeqNumber = currentBaroSeqNumber;
-        }
-
-      osDelay (10);
+      osSignalSet (state_estimation_thread, STATE_ESTIMATION_SIGNAL_BARO);
     }
+}
+
+void TK_state_estimation ()
+{
+  AlphaBetaState filter;
+  uint32_t lastBaroSeqNumber = currentBaroSeqNumber;
+
+  alpha_beta_init (&filter);
+
+  state_estimation_thread = osThreadGetId ();
 
   for (;;)
     {
+      osSignalWait (STATE_ESTIMATION_SIGNAL_BARO, osWaitForever);
 
-      if (lastBaroSeqNumber < currentBaroSeqNumber)
-        {
-          altitude_index++;
-          BARO_data baro = BARO_buffer[currentBaroSeqNumber % CIRC_BUFFER_SIZE];
-          altitude_buffer[altitude_index % ALTITUDE_BUFFER_SIZE][0] = baro.altitude - baro.base_altitude;
-          altitude_buffer[altitude_index % ALTITUDE_BUFFER_SIZE][1] = currentBaroTimestamp;
+      uint32_t seqNumber = currentBaroSeqNumber;
 
-          lastBaroSeqNumber = currentBaroSeqNumber;
+      // samples overwritten in the meantime are lost
+      if (seqNumber - lastBaroSeqNumber > CIRC_BUFFER_SIZE)
+        {
+          lastBaroSeqNumber = seqNumber - CIRC_BUFFER_SIZE;
         }
 
-      float32_t d_t = altitude_buffer[altitude_index % ALTITUDE_BUFFER_SIZE][1]
-          - altitude_buffer[(altitude_index + 1) % ALTITUDE_BUFFER_SIZE][1];
-      d_t /= 1000.0;
-
-      float32_t d_h = altitude_buffer[altitude_index % ALTITUDE_BUFFER_SIZE][0]
-          - altitude_buffer[(altitude_index + 1) % ALTITUDE_BUFFER_SIZE][0];
-
-      float32_t sum = 0.0f;
-      for (int i = 0; i < ALTITUDE_BUFFER_SIZE; ++i)
+      while (lastBaroSeqNumber != seqNumber)
         {
-          sum += altitude_buffer[i][0];
+          BARO_data baro = BARO_buffer[(++lastBaroSeqNumber) % CIRC_BUFFER_SIZE];
+          alpha_beta_step (&filter, baro.altitude - baro.base_altitude, baro.timestamp);
         }
 
-      altitude_estimate = sum / ALTITUDE_BUFFER_SIZE;
-      air_speed_state_estimate = d_h / d_t;
+      altitude_estimate = filter.altitude;
+      air_speed_state_estimate = filter.speed;
 
       //can_setFrame((int32_t) altitude_estimate, DATA_ID_AB_ALT, HAL_GetTick());
       //can_setFrame((int32_t) (air_speed_state_estimate*1000), DATA_ID_AB_AIRSPEED, HAL_GetTick());
-
-      osDelay (3);
     }
 
 }
@@ -0,0 +1,49 @@
+/*
+ * altitude_table.c
+ *
+ * Altitude [m] of the pressures from ALTITUDE_TABLE_MIN_HPA to ALTITUDE_TABLE_MAX_HPA by
+ * steps of ALTITUDE_TABLE_STEP_HPA, with 44330 * (1 - (p / 1018.6)^0.1903) in double
+ * precision. Generated by Tests/gen_altitude_table.c: run make altitude_table in
+ * Tests/ whenever ADJUSTED_SEA_LEVEL_PRESSURE changes.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_board.h>
+
+const float altitude_table[ALTITUDE_TABLE_SIZE] = {
+	9200.5938f, 9111.9361f, 9024.2180f, 8937.4174f, 8851.5134f, 8766.4853f,
+	8682.3135f, 8598.9789f, 8516.4632f, 8434.7486f, 8353.8179f, 8273.6545f,
+	8194.2424f, 8115.5659f, 8037.6100f, 7960.3602f, 7883.8022f, 7807.9224f,
+	7732.7076f, 7658.1448f, 7584.2215f, 7510.9256f, 7438.2453f, 7366.1692f,
+	7294.6862f, 7223.7855f, 7153.4565f, 7083.6891f, 7014.4734f, 6945.7997f,
+	6877.6585f, 6810.0408f, 6742.9377f, 6676.3405f, 6610.2406f, 6544.6300f,
+	6479.5006f, 6414.8446f, 6350.6543f, 6286.9223f, 6223.6414f, 6160.8045f,
+	6098.4047f, 6036.4352f, 5974.8896f, 5913.7612f, 5853.0440f, 5792.7317f,
+	5732.8184f, 5673.2982f, 5614.1654f, 5555.4143f, 5497.0397f, 5439.0360f,
+	5381.3981f, 5324.1209f, 5267.1992f, 5210.6284f, 5154.4035f, 5098.5198f,
+	5042.9728f, 4987.7580f, 4932.8710f, 4878.3074f, 4824.0630f, 4770.1336f,
+	4716.5153f, 4663.2040f, 4610.1958f, 4557.4869f, 4505.0736f, 4452.9522f,
+	4401.1190f, 4349.5705f, 4298.3033f, 4247.3139f, 4196.5990f, 4146.1554f,
+	4095.9798f, 4046.0689f, 3996.4199f, 3947.0295f, 3897.8948f, 3849.0128f,
+	3800.3808f, 3751.9957f, 3703.8549f, 3655.9556f, 3608.2951f, 3560.8708f,
+	3513.6801f, 3466.7203f, 3419.9891f, 3373.4839f, 3327.2023f, 3281.1419f,
+	3235.3003f, 3189.6754f, 3144.2647f, 3099.0660f, 3054.0772f, 3009.2961f,
+	2964.7205f, 2920.3483f, 2876.1776f, 2832.2062f, 2788.4321f, 2744.8535f,
+	2701.4683f, 2658.2746f, 2615.2706f, 2572.4544f, 2529.8242f, 2487.3781f,
+	2445.1145f, 2403.0316f, 2361.1276f, 2319.4009f, 2277.8498f, 2236.4727f,
+	2195.2679f, 2154.2338f, 2113.3689f, 2072.6716f, 2032.1404f, 1991.7738f,
+	1951.5703f, 1911.5284f, 1871.6467f, 1831.9237f, 1792.3581f, 1752.9485f,
+	1713.6935f, 1674.5917f, 1635.6418f, 1596.8426f, 1558.1926f, 1519.6907f,
+	1481.3356f, 1443.1260f, 1405.0607f, 1367.1385f, 1329.3581f, 1291.7185f,
+	1254.2184f, 1216.8568f, 1179.6323f, 1142.5440f, 1105.5908f, 1068.7714f,
+	1032.0849f, 995.5302f, 959.1063f, 922.8120f, 886.6464f, 850.6084f,
+	814.6971f, 778.9115f, 743.2505f, 707.7132f, 672.2987f, 637.0060f,
+	601.8342f, 566.7823f, 531.8495f, 497.0349f, 462.3374f, 427.7564f,
+	393.2909f, 358.9400f, 324.7030f, 290.5789f, 256.5669f, 222.6663f,
+	188.8761f, 155.1957f, 121.6241f, 88.1607f, 54.8046f, 21.5552f,
+	-11.5885f, -44.6271f, -77.5613f, -110.3920f, -143.1198f, -175.7454f,
+	-208.2696f, -240.6930f, -273.0164f, -305.2404f, -337.3657f, -369.3931f,
+	-401.3231f, -433.1564f, -464.8936f, -496.5355f, -528.0827f, -559.5357f,
+	-590.8952f, -622.1619f, -653.3363f
+};
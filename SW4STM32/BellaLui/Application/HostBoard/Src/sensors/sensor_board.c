@@ -28,37 +28,65 @@
 #include "../../../HostBoard/Inc/Misc/rocket_constants.h"
 #include "../../../HostBoard/Inc/Sensors/BME280/bme280.h"
 #include "../../../HostBoard/Inc/Sensors/BNO055/bno055.h"
+#include "../../../HostBoard/Inc/Sensors/sensor_health.h"
+#include "../../../HostBoard/Inc/Sensors/sensor_i2c.h"
+#include "../../../HostBoard/Inc/Sensors/sensor_sampling.h"
+#include "../../../HostBoard/Inc/Sensors/sensor_vote.h"
+#include "../../../HostBoard/Inc/threads.h"
+
+#include "../../../HostBoard/Inc/debug/profiler.h"
+
+#if defined(NUMERICS_BENCHMARK) || defined(BNO_BENCHMARK) || defined(BME_BENCHMARK) || defined(ACQUISITION_BENCHMARK)
+#include "../../../HostBoard/Inc/debug/console.h"
+#endif
 
-#define I2C_TIMEOUT 3
-#define FMPI2C_TIMEOUT 3
 #define BARO_CALIB_N 128
-#define normal_coef 3.000   // coefficient for a 99 % confidence interval
 #define MAX_SENSOR_NUMBER 4
+#define BNO_BURST_LENGTH 18 // accel, mag and gyro data registers, contiguous from BNO055_ACCEL_DATA_X_LSB_ADDR
+#define BME_BURST_LENGTH 6 // pressure and temperature data registers, contiguous from BME280_DATA_ADDR
+#define BUS_QUEUE_LENGTH (4 * MAX_SENSOR_NUMBER / SENSOR_I2C_BUSES) // transactions of a bus per cycle, see enum transaction
+#define PROBE_POLL_MS 100 // [ms] between two looks for the sensors to re-initialise
+#define BNO_VOTE_KINDS 2 // accel then gyro vectors
+#define BME_VOTE_AXES 2 // pressure then temperature
+
+#ifndef RAW_SAMPLE_PERIOD
+#define RAW_SAMPLE_PERIOD 100 // cycles between two raw samples of each sensor, 1 s at 100 Hz
+#endif
+
+// spread between healthy sensors, from their datasheet accuracy
+#define BNO_ACCEL_TOLERANCE 80.0f // [mg] zero-g offset, per axis
+#define BNO_GYRO_TOLERANCE 0.02f // [rad/s] zero rate offset, about 1 dps
+#define BME_PRESSURE_TOLERANCE 100.0f // [Pa] absolute accuracy
+#define BME_TEMPERATURE_TOLERANCE 100.0f // [0.01 degC] absolute accuracy
+
+_Static_assert(MAX_SENSOR_NUMBER <= VOTE_MAX_SENSORS, "more sensors than the vote takes");
 
 /* sensor_id is the index of the sensor, which is different form the dev_id ( defined in bme280_dev)
  * or dev_addr ( defined in bno055_t) representing its address for the I2C protocol
  */
 
 int8_t init_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER]);
+const struct bme_phase* current_bme_phase();
+uint32_t bme_measure_ms(uint8_t osr_t, uint8_t osr_p);
 int8_t init_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER]);
-int8_t fetch_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER]);
-int8_t fetch_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER]);
+int8_t fetch_bme(uint8_t sensor_id, const uint8_t* raw, int8_t status, int8_t rslt_bme[MAX_SENSOR_NUMBER]);
+int8_t fetch_bno(uint8_t sensor_id, const uint8_t* raw, int8_t status, int8_t rslt_bno[MAX_SENSOR_NUMBER]);
+void acquire(uint8_t imu_active[MAX_SENSOR_NUMBER], uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], uint8_t baro_read[MAX_SENSOR_NUMBER]);
 
 int8_t stm32_i2c_read (uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
 int8_t stm32_i2c_write (uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
 void stm32_delay_ms (uint32_t delay);
-void sensor_elimination_4(float value_0, float value_1, float value_2, float value_3, float *correct_value, bool erroneous_sensor[MAX_SENSOR_NUMBER]);
-void sensor_elimination_3(float value[MAX_SENSOR_NUMBER], uint8_t index_0, uint8_t index_1, uint8_t index_2, float *correct_value, bool erroneous_sensor[MAX_SENSOR_NUMBER]);
-void sensor_elimination_2(float value[MAX_SENSOR_NUMBER], uint8_t index_0, uint8_t index_1, float *correct_value, bool erroneous_sensor[MAX_SENSOR_NUMBER]);
-bool within_conf_interval_4(float value_0, float data_1, float data_2, float data_3);
-bool within_conf_interval_3(float value_0, float data_1, float data_2);
-void bme_redundancy(int8_t rslt_bme[MAX_SENSOR_NUMBER]);
-void bno_redundancy(int8_t rslt_bno[MAX_SENSOR_NUMBER]);
-void bme_data_process(uint8_t bme_init[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], uint8_t cntr);
-void bno_data_process(uint8_t imu_init[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], uint8_t cntr);
-
-extern I2C_HandleTypeDef hi2c3;
-extern FMPI2C_HandleTypeDef hfmpi2c1;
+int8_t bme_i2c_read (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+int8_t bme_i2c_write (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len);
+int8_t bno_i2c_read (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint8_t len);
+int8_t bno_i2c_write (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint8_t len);
+uint8_t bme_redundancy(uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], bool rejected[MAX_SENSOR_NUMBER]);
+uint8_t bno_redundancy(uint8_t imu_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], bool rejected[MAX_SENSOR_NUMBER]);
+bool bme_data_process(uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], uint8_t cntr, bool rejected[MAX_SENSOR_NUMBER]);
+bool bno_data_process(uint8_t imu_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], uint8_t cntr, bool rejected[MAX_SENSOR_NUMBER]);
+void send_sample(bool imu, bool baro);
+void send_raw_samples(uint8_t imu_active[MAX_SENSOR_NUMBER], uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER]);
+void sensor_benchmarkNumerics(void);
 
 char buf[300];
 
@@ -74,6 +102,7 @@ struct bme280_data_float
 	float temperature;
 	float pressure;
 	float basepressure;
+	uint32_t timestamp; // [ms] middle of the conversion
 };
 
 //## BME280 ## Barometer
@@ -92,6 +121,55 @@ struct bno055_t bno[MAX_SENSOR_NUMBER];
 struct bno055_data bno_data[MAX_SENSOR_NUMBER];
 struct bno055_data correct_bno_data;
 
+// written by TK_sensor_board for the acquired sensors, by TK_sensor_probe for the others
+Sensor_health_tracker imu_health[MAX_SENSOR_NUMBER], baro_health[MAX_SENSOR_NUMBER];
+
+uint32_t acquisition_us; // to fetch all the sensors in the last cycle
+uint32_t sample_timestamp; // [ms] trigger of the acquisition of the current cycle, for all its frames
+
+// sensor addressed by the driver calls of init_bme and init_bno, whose bus functions have no sensor_id;
+// only TK_sensor_probe initialises the sensors
+uint8_t driver_sensor_id;
+
+/*
+ * BME280 forced mode: each conversion is started by the sensor board, with the settings of
+ * the current flight phase, and read in a later cycle once over. The pad and the descent
+ * trade the rate for a lower noise, the powered flight gets a conversion every cycle.
+ */
+
+struct bme_phase
+{
+	uint8_t first_state; // of the flight phase, up to the first state of the next one
+	uint8_t osr_p, osr_t, filter;
+};
+
+static const struct bme_phase bme_phases[] = {
+	{ STATE_SLEEP, BME280_OVERSAMPLING_16X, BME280_OVERSAMPLING_2X, BME280_FILTER_COEFF_16 }, // 44 ms
+	{ STATE_LIFTOFF, BME280_OVERSAMPLING_2X, BME280_OVERSAMPLING_1X, BME280_FILTER_COEFF_OFF }, // 9 ms
+	{ STATE_COAST, BME280_OVERSAMPLING_4X, BME280_OVERSAMPLING_1X, BME280_FILTER_COEFF_4 }, // 14 ms
+	{ STATE_PRIMARY, BME280_OVERSAMPLING_8X, BME280_OVERSAMPLING_1X, BME280_FILTER_COEFF_4 }, // 23 ms
+	{ STATE_TOUCHDOWN, BME280_OVERSAMPLING_16X, BME280_OVERSAMPLING_2X, BME280_FILTER_COEFF_16 } // 44 ms
+};
+
+uint32_t bme_ready_at[MAX_SENSOR_NUMBER]; // [ms] end of the conversion in progress
+uint32_t bme_sampled_at[MAX_SENSOR_NUMBER]; // [ms] middle of the conversion in progress
+
+enum transaction
+{
+	READ_IMU, // BNO055 data
+	READ_BARO, // BME280 data, when its conversion is over
+	CONFIGURE_BARO, // filter of the phase, written between two conversions when it changes
+	TRIGGER_BARO // start of the next conversion
+};
+
+struct acquisition
+{
+	uint8_t sensor_id;
+	enum transaction transaction;
+	uint32_t start; // [cycles]
+	uint8_t raw[BNO_BURST_LENGTH]; // data registers, or the BME280 register written
+};
+
 uint8_t led_sensor_id_imu, led_sensor_id_baro;
 uint8_t set_sensor_led(uint8_t id, uint8_t flag) {
 	if (flag) { // success
@@ -104,78 +182,173 @@ uint8_t set_sensor_led(uint8_t id, uint8_t flag) {
 
 
 /*
- * Main function used to initialize and fetch the sensors.
+ * Before the scheduler starts: every sensor is to be initialised by TK_sensor_probe.
+ */
+
+void sensor_board_init() {
+	for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+		health_init(&imu_health[sensor_id]);
+		health_init(&baro_health[sensor_id]);
+	}
+}
+
+/*
+ * Main function used to fetch the sensors.
+ *
+ * Each cycle starts at a trigger of the sampling timer, every SAMPLING_PERIOD_US,
+ * and its frames carry the time of the trigger. The baros are only read, voted and sent
+ * in the cycles that end one of their conversions, whose time their frames carry.
+ *
+ * A cycle sends a single sample of the voted data, in DATA_ID_SAMPLE_FRAMES frames at
+ * most, instead of frames for each sensor and each axis. The data of each sensor is only
+ * sent every RAW_SAMPLE_PERIOD cycles, together with the base pressure.
  *
- * If at least one BME or BNO has been initialized, the redundancy
- * algorithm is called.
+ * Only the good and suspect sensors are acquired. A sensor that fails to be fetched or
+ * whose data is discarded by the redundancy algorithm has a faulty cycle, which its
+ * health keeps track of. The health of all the sensors is sent when it changes, and
+ * every SAMPLING_STATS_WINDOW cycles.
  */
 
 void TK_sensor_board(void const * argument) {
 
-	uint8_t imu_init[MAX_SENSOR_NUMBER] = {0}, baro_init[MAX_SENSOR_NUMBER]= {0};
-	osDelay(500);
-	uint8_t cntr = 0;
-	int8_t rslt_bme[MAX_SENSOR_NUMBER] = {1}, rslt_bno[MAX_SENSOR_NUMBER] = {1}; // rslt_xxx = 0 if no problem, 1 otherwise
+	uint8_t imu_active[MAX_SENSOR_NUMBER] = {0}, baro_active[MAX_SENSOR_NUMBER]= {0}, baro_read[MAX_SENSOR_NUMBER] = {0};
+	bool imu_rejected[MAX_SENSOR_NUMBER], baro_rejected[MAX_SENSOR_NUMBER];
+	uint32_t health = 0, last_health = UINT32_MAX;
 
 	led_sensor_id_imu  = led_register_TK();
 	led_sensor_id_baro = led_register_TK();
 
+	osDelay(500);
+	uint8_t cntr = 0;
+	int8_t rslt_bme[MAX_SENSOR_NUMBER], rslt_bno[MAX_SENSOR_NUMBER]; // rslt_xxx = 0 if no problem, 1 otherwise
+	for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+		rslt_bme[sensor_id] = rslt_bno[sensor_id] = 1;
+	}
+
+#ifdef NUMERICS_BENCHMARK
+	sensor_benchmarkNumerics();
+#endif
+
+	profiler_init();
+
+#ifdef ACQUISITION_BENCHMARK
+	uint32_t acquisition_us_total = 0, acquisition_us_max = 0, iter = 0;
+#endif
+
+	Sampling_trigger trigger;
+	Sampling_stats sampling_stats;
+	uint32_t sampling_cycles = 0;
+
+	sampling_start(SAMPLING_PERIOD_US);
+
 	for(;;) {
-		if (imu_init[0]) { //BNO
-			set_sensor_led(led_sensor_id_imu, fetch_bno(0, rslt_bno) == BNO055_SUCCESS); //BNO055_SUCCESS = 0
-		} else {
-			imu_init[0] = set_sensor_led(led_sensor_id_imu, init_bno(0, rslt_bno) == BNO055_SUCCESS);
-		}
-		if (imu_init[1]) {
-			set_sensor_led(led_sensor_id_imu, fetch_bno(1, rslt_bno) == BNO055_SUCCESS);
-		} else {
-			imu_init[1] = set_sensor_led(led_sensor_id_imu, init_bno(1, rslt_bno) == BNO055_SUCCESS);
+		sampling_wait(&trigger);
+		sample_timestamp = trigger.timestamp;
+
+		bool any_active = false;
+		for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+			imu_active[sensor_id] = health_isAcquired(&imu_health[sensor_id]);
+			baro_active[sensor_id] = health_isAcquired(&baro_health[sensor_id]);
+			imu_rejected[sensor_id] = baro_rejected[sensor_id] = false;
+			any_active |= imu_active[sensor_id] || baro_active[sensor_id];
 		}
-		if (imu_init[2]) {
-			set_sensor_led(led_sensor_id_imu, fetch_bno(2, rslt_bno) == BNO055_SUCCESS);
-		} else {
-			imu_init[2] = set_sensor_led(led_sensor_id_imu, init_bno(2, rslt_bno) == BNO055_SUCCESS);
+
+		acquire(imu_active, baro_active, rslt_bno, rslt_bme, baro_read);
+
+#ifdef ACQUISITION_BENCHMARK
+		acquisition_us_total += acquisition_us;
+		if (acquisition_us > acquisition_us_max) acquisition_us_max = acquisition_us;
+		if (++iter % 100 == 0) {
+			rocket_log("Acquisition: %ld us average, %ld us max\n", acquisition_us_total / 100, acquisition_us_max);
+			acquisition_us_total = 0;
+			acquisition_us_max = 0;
 		}
-		if (imu_init[3]) {
-			set_sensor_led(led_sensor_id_imu, fetch_bno(3, rslt_bno) == BNO055_SUCCESS);
-		} else {
-			imu_init[3] = set_sensor_led(led_sensor_id_imu, init_bno(3, rslt_bno) == BNO055_SUCCESS);
+#endif
+
+		if (any_active)
+		{ // Redundancy
+			bool baro_voted = bme_data_process(baro_read, rslt_bme, cntr, baro_rejected);
+			bool imu_voted = bno_data_process(imu_active, rslt_bno, cntr, imu_rejected);
+
+			send_sample(imu_voted, baro_voted);
 		}
-		if (baro_init[0]) { //BME
-			set_sensor_led(led_sensor_id_baro, fetch_bme(0, rslt_bme) == BME280_OK); //BME280_OK = 0
-		} else {
-			baro_init[0] = set_sensor_led(led_sensor_id_baro, init_bme(0, rslt_bme) == BME280_OK);
+
+		taskENTER_CRITICAL();
+		for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+			if (imu_active[sensor_id]) {
+				health_update(&imu_health[sensor_id], rslt_bno[sensor_id] || imu_rejected[sensor_id], sample_timestamp);
+			}
+			if (baro_read[sensor_id]) {
+				health_update(&baro_health[sensor_id], rslt_bme[sensor_id] || baro_rejected[sensor_id], sample_timestamp);
+			}
 		}
-		if (baro_init[1]) {
-			set_sensor_led(led_sensor_id_baro, fetch_bme(1, rslt_bme) == BME280_OK);
-		} else {
-			baro_init[1] = set_sensor_led(led_sensor_id_baro, init_bme(1, rslt_bme) == BME280_OK);
+		health = health_pack(imu_health, MAX_SENSOR_NUMBER) | health_pack(baro_health, MAX_SENSOR_NUMBER) << (HEALTH_BITS * MAX_SENSOR_NUMBER);
+		taskEXIT_CRITICAL();
+
+		if (sampling_cycles % RAW_SAMPLE_PERIOD == 0) {
+			send_raw_samples(imu_active, baro_active, rslt_bno, rslt_bme);
+
+			if (correct_bme_calibrated) {
+				can_setFrame((int32_t) (100 * correct_bme_basepressure), DATA_ID_CALIB_PRESSURE, sample_timestamp);
+			}
 		}
-		if (baro_init[2]) {
-			set_sensor_led(led_sensor_id_baro, fetch_bme(2, rslt_bme) == BME280_OK);
-		} else {
-			baro_init[2] = set_sensor_led(led_sensor_id_baro, init_bme(2, rslt_bme) == BME280_OK);
+
+		if (++sampling_cycles % SAMPLING_STATS_WINDOW == 0) {
+			sampling_takeStats(&sampling_stats);
+			can_setFrame((int32_t) sampling_stats.period_jitter_us, DATA_ID_SAMPLING_JITTER, sample_timestamp);
+			can_setFrame(sampling_stats.latency_max_us, DATA_ID_SAMPLING_LATENCY, sample_timestamp);
+			last_health = UINT32_MAX;
 		}
-		if (baro_init[3]) {
-			set_sensor_led(led_sensor_id_baro, fetch_bme(3, rslt_bme) == BME280_OK);
-		} else {
-			baro_init[3] = set_sensor_led(led_sensor_id_baro, init_bme(3, rslt_bme) == BME280_OK);
+
+		if (health != last_health) {
+			can_setFrame(health, DATA_ID_SENSOR_HEALTH, sample_timestamp);
+			last_health = health;
 		}
 
-		osDelay(10);
+		cntr = ++cntr < 30 ? cntr : 2;
+	}
+}
 
-		if(!baro_init[0] && !baro_init[1] && !baro_init[2] && !baro_init[3]
-		    && !imu_init[0] && !imu_init[1] && !imu_init[2] && !imu_init[3])
-		{ // If none of the sensors are initialized
-			osDelay(1000);
-		}
-		else
-		{ // Redundancy
-			bme_data_process(baro_init, rslt_bme, cntr);
-			bno_data_process(imu_init, rslt_bno, cntr);
+static void probe(Sensor_health_tracker* h, uint8_t sensor_id, bool imu)
+{
+	int8_t rslt[MAX_SENSOR_NUMBER];
+	bool success;
+
+	taskENTER_CRITICAL();
+	bool due = health_probeDue(h, HAL_GetTick());
+	taskEXIT_CRITICAL();
+
+	if (!due) {
+		return;
+	}
+
+	if (imu) {
+		success = set_sensor_led(led_sensor_id_imu, init_bno(sensor_id, rslt) == BNO055_SUCCESS); //BNO055_SUCCESS = 0
+	} else {
+		success = set_sensor_led(led_sensor_id_baro, init_bme(sensor_id, rslt) == BME280_OK); //BME280_OK = 0
+	}
+
+	taskENTER_CRITICAL();
+	health_probed(h, success, HAL_GetTick());
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Initialises the sensors at start-up, then re-initialises the excluded ones once their
+ * probe interval is over. It runs below TK_sensor_board: the acquisitions only wait for
+ * the I2C transaction in progress, not for a whole initialisation.
+ */
+
+void TK_sensor_probe(void const * argument) {
+	osDelay(500);
+
+	for(;;) {
+		for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+			probe(&imu_health[sensor_id], sensor_id, true);
+			probe(&baro_health[sensor_id], sensor_id, false);
 		}
 
-		cntr = ++cntr < 30 ? cntr : 2;
+		osDelay(PROBE_POLL_MS);
 	}
 }
 
@@ -192,6 +365,46 @@ void TK_sensor_board(void const * argument) {
  */
 
 
+const struct bme_phase* current_bme_phase()
+{
+	uint8_t i = 0;
+
+	while (i + 1 < sizeof(bme_phases) / sizeof(bme_phases[0]) && currentState >= bme_phases[i + 1].first_state) {
+		i++;
+	}
+
+	return &bme_phases[i];
+}
+
+static uint32_t bme_oversamples(uint8_t osr)
+{
+	return osr == BME280_NO_OVERSAMPLING ? 0 : 1 << (osr - 1);
+}
+
+/*
+ * Maximum conversion time of the datasheet, rounded up: 1.25 ms, then 2.3 ms per
+ * temperature and pressure sample and 0.575 ms more for the pressure.
+ */
+uint32_t bme_measure_ms(uint8_t osr_t, uint8_t osr_p)
+{
+	uint32_t us = 1250 + 2300 * bme_oversamples(osr_t);
+
+	if (osr_p != BME280_NO_OVERSAMPLING) {
+		us += 2300 * bme_oversamples(osr_p) + 575;
+	}
+
+	return (us + 999) / 1000;
+}
+
+// a conversion of the driver settings started at the time given [ms]
+static void bme_converting(uint8_t sensor_id, uint32_t start)
+{
+	uint32_t measure_ms = bme_measure_ms(bme[sensor_id].settings.osr_t, bme[sensor_id].settings.osr_p);
+
+	bme_ready_at[sensor_id] = start + measure_ms;
+	bme_sampled_at[sensor_id] = start + measure_ms / 2;
+}
+
 int8_t init_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER])
 {
 	if (sensor_id == 1 || sensor_id == 2) {
@@ -201,9 +414,10 @@ int8_t init_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER])
 		bme[sensor_id].dev_id = BME280_I2C_ADDR_SEC;
 	}
 	bme[sensor_id].intf = BME280_I2C_INTF;
-	bme[sensor_id].read = &stm32_i2c_read;
-	bme[sensor_id].write = &stm32_i2c_write;
+	bme[sensor_id].read = &bme_i2c_read;
+	bme[sensor_id].write = &bme_i2c_write;
 	bme[sensor_id].delay_ms = &stm32_delay_ms;
+	driver_sensor_id = sensor_id;
 
 	rslt_bme[sensor_id] = bme280_init(&bme[sensor_id]); // Returns 1 if error
 	if (rslt_bme[sensor_id] != BME280_OK) {
@@ -214,18 +428,21 @@ int8_t init_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER])
 	if (rslt_bme[sensor_id] != BME280_OK) {
 		return rslt_bme[sensor_id];
 	}
-	//Overwrite the desired settings
-	bme[sensor_id].settings.filter = BME280_FILTER_COEFF_OFF;
-	bme[sensor_id].settings.osr_p = BME280_OVERSAMPLING_8X;
-	bme[sensor_id].settings.osr_t = BME280_OVERSAMPLING_1X;
+	//Overwrite the desired settings, no humidity conversion
+	const struct bme_phase* phase = current_bme_phase();
+	bme[sensor_id].settings.filter = phase->filter;
+	bme[sensor_id].settings.osr_p = phase->osr_p;
+	bme[sensor_id].settings.osr_t = phase->osr_t;
+	bme[sensor_id].settings.osr_h = BME280_NO_OVERSAMPLING;
 	bme[sensor_id].settings.standby_time = BME280_STANDBY_TIME_0_5_MS;
 
 	rslt_bme[sensor_id] = bme280_set_sensor_settings(BME280_ALL_SETTINGS_SEL, &bme[sensor_id]);
 	if (rslt_bme[sensor_id] != BME280_OK) {
 		return rslt_bme[sensor_id];
 	}
-	//Always set the power mode after setting the configuration
-	rslt_bme[sensor_id] = bme280_set_sensor_mode(BME280_NORMAL_MODE, &bme[sensor_id]);
+	//Always set the power mode after setting the configuration: starts the first conversion
+	rslt_bme[sensor_id] = bme280_set_sensor_mode(BME280_FORCED_MODE, &bme[sensor_id]);
+	bme_converting(sensor_id, HAL_GetTick());
 
 	bme_calibrated[sensor_id] = false;
 	bme_calib_counter[sensor_id] = 0;
@@ -241,9 +458,10 @@ int8_t init_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER])
 	else if (sensor_id == 0 || sensor_id == 3) {
 		bno[sensor_id].dev_addr = BNO055_I2C_ADDR2;
 	}
-	bno[sensor_id].bus_write = &stm32_i2c_write;
-	bno[sensor_id].bus_read = &stm32_i2c_read;
+	bno[sensor_id].bus_write = &bno_i2c_write;
+	bno[sensor_id].bus_read = &bno_i2c_read;
 	bno[sensor_id].delay_msec = &stm32_delay_ms;
+	driver_sensor_id = sensor_id;
 
 	rslt_bno[sensor_id] = bno055_init(&bno[sensor_id]); // Returns 1 if error
 	if(rslt_bno[sensor_id] != BNO055_SUCCESS)
@@ -258,14 +476,183 @@ int8_t init_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER])
 		return rslt_bno[sensor_id];
 
 	rslt_bno[sensor_id] = bno055_set_accel_range(BNO055_ACCEL_RANGE_16G);
+	if(rslt_bno[sensor_id] != BNO055_SUCCESS)
+		return rslt_bno[sensor_id];
+
+	// units of the data registers, once and for all before the burst reads of fetch_bno
+	rslt_bno[sensor_id] = bno055_set_accel_unit(BNO055_ACCEL_UNIT_MG);
+	if(rslt_bno[sensor_id] != BNO055_SUCCESS)
+		return rslt_bno[sensor_id];
+
+	rslt_bno[sensor_id] = bno055_set_gyro_unit(BNO055_GYRO_UNIT_RPS);
 
 	return rslt_bno[sensor_id];
 }
 
+/*
+ * Acquisition scheduler :
+ *
+ * One queue of transactions per bus, each one started as soon as the previous one of its
+ * bus is over: the sensors of I2C3 and FMPI2C1 are fetched at the same time.
+ * A baro is only read once its conversion is over, and the next one is triggered right
+ * after: both come at the same point of their cycles, the conversion time is counted from
+ * the cycle trigger. The time spent goes to acquisition_us.
+ */
+
+static void start_acquisition(struct acquisition* a)
+{
+	a->start = profiler_cycles();
+
+	switch (a->transaction) {
+	case READ_IMU:
+		sensor_i2c_start_read(a->sensor_id, bno[a->sensor_id].dev_addr, BNO055_ACCEL_DATA_X_LSB_ADDR, a->raw, BNO_BURST_LENGTH);
+		break;
+	case READ_BARO:
+		sensor_i2c_start_read(a->sensor_id, bme[a->sensor_id].dev_id, BME280_DATA_ADDR, a->raw, BME_BURST_LENGTH);
+		break;
+	case CONFIGURE_BARO:
+		sensor_i2c_start_write(a->sensor_id, bme[a->sensor_id].dev_id, BME280_CONFIG_ADDR, a->raw, 1);
+		break;
+	case TRIGGER_BARO:
+		sensor_i2c_start_write(a->sensor_id, bme[a->sensor_id].dev_id, BME280_CTRL_MEAS_ADDR, a->raw, 1);
+		break;
+	}
+}
+
+static void enqueue(struct acquisition* queue, uint8_t* length, uint8_t sensor_id, enum transaction transaction, uint8_t reg_data)
+{
+	queue[*length].sensor_id = sensor_id;
+	queue[*length].transaction = transaction;
+	queue[*length].raw[0] = reg_data;
+	(*length)++;
+}
+
+/*
+ * Outcome of the writes to a baro: the settings of the driver follow those of the sensor,
+ * and a failed write is a faulty cycle.
+ */
+static void baro_written(struct acquisition* a, int8_t status, int8_t rslt_bme[MAX_SENSOR_NUMBER])
+{
+	struct bme280_settings* settings = &bme[a->sensor_id].settings;
+
+	if (status != HAL_OK) {
+		rslt_bme[a->sensor_id] = BME280_E_COMM_FAIL;
+	} else if (a->transaction == CONFIGURE_BARO) {
+		settings->filter = a->raw[0] >> 2;
+	} else {
+		settings->osr_t = a->raw[0] >> 5;
+		settings->osr_p = (a->raw[0] >> 2) & 0x07;
+		bme_converting(a->sensor_id, sample_timestamp);
+	}
+}
+
+void acquire(uint8_t imu_active[MAX_SENSOR_NUMBER], uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], uint8_t baro_read[MAX_SENSOR_NUMBER])
+{
+	struct acquisition queue[SENSOR_I2C_BUSES][BUS_QUEUE_LENGTH];
+	uint8_t length[SENSOR_I2C_BUSES] = {0}, next[SENSOR_I2C_BUSES] = {0};
+	uint32_t busy = 0; // bits of the buses with a transaction in flight
+	const struct bme_phase* phase = current_bme_phase();
+
+#ifdef BNO_BENCHMARK
+	static uint32_t samples = 0, bno_cycles = 0;
+#endif
+#ifdef BME_BENCHMARK
+	static uint32_t bme_samples = 0, bme_cycles = 0, bme_compensation_cycles = 0;
+#endif
+
+	// IMUs first on each bus, as they are sampled faster
+	for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+		enum Sensor_i2c_bus bus = sensor_i2c_bus(sensor_id);
+		if (imu_active[sensor_id]) {
+			enqueue(queue[bus], &length[bus], sensor_id, READ_IMU, 0);
+		}
+	}
+	// the others keep the data of their last conversion, and are left out of this cycle
+	for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+		enum Sensor_i2c_bus bus = sensor_i2c_bus(sensor_id);
+		baro_read[sensor_id] = baro_active[sensor_id] && (int32_t) (sample_timestamp - bme_ready_at[sensor_id]) >= 0;
+		if (baro_read[sensor_id]) {
+			enqueue(queue[bus], &length[bus], sensor_id, READ_BARO, 0);
+			if (bme[sensor_id].settings.filter != phase->filter) {
+				enqueue(queue[bus], &length[bus], sensor_id, CONFIGURE_BARO, phase->filter << 2);
+			}
+			enqueue(queue[bus], &length[bus], sensor_id, TRIGGER_BARO, phase->osr_t << 5 | phase->osr_p << 2 | BME280_FORCED_MODE);
+		}
+	}
+
+	uint32_t start = profiler_cycles();
+
+	for (int bus = 0; bus < SENSOR_I2C_BUSES; bus++) {
+		if (length[bus]) {
+			start_acquisition(&queue[bus][0]);
+			busy |= 1 << bus;
+		}
+	}
+
+	while (busy) {
+		// after the timeout, the ends below abort the transactions still in flight
+		uint32_t over = sensor_i2c_wait(busy, SENSOR_I2C_TIMEOUT_MS);
+		if (!over) {
+			over = busy;
+		}
+
+		for (int bus = 0; bus < SENSOR_I2C_BUSES; bus++) {
+			if (!(over & (1 << bus))) {
+				continue;
+			}
+
+			struct acquisition* a = &queue[bus][next[bus]];
+			int8_t status = sensor_i2c_end(bus);
+
+			// the bus works on the next transaction while this one is processed
+			if (++next[bus] < length[bus]) {
+				start_acquisition(&queue[bus][next[bus]]);
+			} else {
+				busy &= ~(1 << bus);
+			}
+
+			if (a->transaction == READ_IMU) {
+				set_sensor_led(led_sensor_id_imu, fetch_bno(a->sensor_id, a->raw, status, rslt_bno) == BNO055_SUCCESS);
+
+#ifdef BNO_BENCHMARK
+				bno_cycles += profiler_cycles() - a->start;
+				if (++samples % 100 == 0) {
+					// device address and register written, device address read again, then the data
+					rocket_log("BNO: %d bytes on the bus, %ld cycles per sample\n", 3 + BNO_BURST_LENGTH, bno_cycles / 100);
+					bno_cycles = 0;
+				}
+#endif
+			} else if (a->transaction == READ_BARO) {
+#ifdef BME_BENCHMARK
+				uint32_t fetched = profiler_cycles();
+#endif
+				set_sensor_led(led_sensor_id_baro, fetch_bme(a->sensor_id, a->raw, status, rslt_bme) == BME280_OK);
+
+#ifdef BME_BENCHMARK
+				bme_compensation_cycles += profiler_cycles() - fetched;
+				bme_cycles += profiler_cycles() - a->start;
+				if (++bme_samples % 100 == 0) {
+					// the read as for the BNO, then device address, register and value of the trigger
+					rocket_log("BME: %d bytes on the bus, %ld cycles per sample, %ld to compensate\n", 3 + BME_BURST_LENGTH + 3,
+							bme_cycles / 100, bme_compensation_cycles / 100);
+					bme_cycles = 0;
+					bme_compensation_cycles = 0;
+				}
+#endif
+			} else {
+				baro_written(a, status, rslt_bme);
+			}
+		}
+	}
+
+	acquisition_us = (profiler_cycles() - start) / (SystemCoreClock / 1000000);
+}
+
 /*
  * Fetch functions :
  *
- * Used to fetch the sensors
+ * Used to process the data registers read by the acquisition scheduler,
+ * with the HAL status of the read
  * Returns an array ( rslt_bme, rslt_bno ) of size MAX_SENSOR_NUMBER
  * stating if the fetch was completed or not
  *
@@ -274,15 +661,31 @@ int8_t init_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER])
  *
  */
 
-int8_t fetch_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER])
+static inline uint32_t bme_adc(const uint8_t* msb)
+{
+	return ((uint32_t) msb[0] << 12) | ((uint32_t) msb[1] << 4) | (msb[2] >> 4);
+}
+
+/*
+ * Only the pressure and temperature registers are read, and compensated with the integer
+ * path of the driver: the humidity is neither converted nor compensated.
+ */
+int8_t fetch_bme(uint8_t sensor_id, const uint8_t* raw, int8_t status, int8_t rslt_bme[MAX_SENSOR_NUMBER])
 {
 	static uint8_t cntr = 0;
-	bme[sensor_id].read = &stm32_i2c_read;
-	bme[sensor_id].write = &stm32_i2c_write;
+	struct bme280_uncomp_data uncomp_data = { 0 };
+
+	if (status == HAL_OK) {
+		uncomp_data.pressure = bme_adc(raw);
+		uncomp_data.temperature = bme_adc(raw + 3);
+		rslt_bme[sensor_id] = bme280_compensate_data(BME280_PRESS | BME280_TEMP, &uncomp_data, &bme_data[sensor_id], &bme[sensor_id].calib_data);
+	} else {
+		rslt_bme[sensor_id] = BME280_E_COMM_FAIL;
+	}
 
-	rslt_bme[sensor_id] = bme280_get_sensor_data(BME280_ALL, &bme_data[sensor_id], &bme[sensor_id]);
 	bme_data_float[sensor_id].temperature = (float) bme_data[sensor_id].temperature;
 	bme_data_float[sensor_id].pressure = (float) bme_data[sensor_id].pressure/100;
+	bme_data_float[sensor_id].timestamp = bme_sampled_at[sensor_id]; // the conversion just over
 	if (!rslt_bme[sensor_id])
 	{
 		if (!bme_calibrated[sensor_id]) {
@@ -293,17 +696,13 @@ int8_t fetch_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER])
 				bme_data_float[sensor_id].basepressure /= BARO_CALIB_N;
 				bme_calibrated[sensor_id] = true;
 			}
-		} else if (cntr==0) {
-			can_setFrame(bme_data_float[sensor_id].basepressure, DATA_ID_CALIB_PRESSURE, HAL_GetTick());
 		}
 
-		can_setFrame(bme_data_float[sensor_id].temperature, DATA_ID_TEMPERATURE, HAL_GetTick());
-		can_setFrame(bme_data_float[sensor_id].pressure/100, DATA_ID_PRESSURE, HAL_GetTick());
-
 		if(!cntr)
 		{
-			sprintf(buf, "Pres: %"PRIu32"\nTemp: %"PRIu32"\nHum: %"PRIu32"\n",
-					bme_data_float[sensor_id].pressure, bme_data_float[sensor_id].temperature, bme_data[sensor_id].humidity);
+			// formats doubles: to be enabled together with the print
+			//sprintf(buf, "Pres: %f\nTemp: %f\nHum: %"PRIu32"\n",
+			//		(double) bme_data_float[sensor_id].pressure, (double) bme_data_float[sensor_id].temperature, bme_data[sensor_id].humidity);
 			//INFO(buf);
 		}
 	}
@@ -313,31 +712,40 @@ int8_t fetch_bme(uint8_t sensor_id, int8_t rslt_bme[MAX_SENSOR_NUMBER])
 	return rslt_bme[sensor_id];
 }
 
-int8_t fetch_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER])
+static inline float bno_axis(const uint8_t* lsb)
+{
+	return (float) (int16_t) ((lsb[1] << 8) | lsb[0]);
+}
+
+/*
+ * All the data registers of the sensor come in a single transaction, in the units set
+ * by init_bno, instead of one unit check and one read per vector through the driver.
+ */
+int8_t fetch_bno(uint8_t sensor_id, const uint8_t* raw, int8_t status, int8_t rslt_bno[MAX_SENSOR_NUMBER])
 {
 	static uint8_t cntr = 0;
-	bno[sensor_id].bus_write = &stm32_i2c_write;
-	bno[sensor_id].bus_read = &stm32_i2c_read;
 
-	rslt_bno[sensor_id] += bno055_convert_float_accel_xyz_mg (&bno_data[sensor_id].accel);
-	rslt_bno[sensor_id] += bno055_convert_float_mag_xyz_uT (&bno_data[sensor_id].mag);
-	rslt_bno[sensor_id] += bno055_convert_float_gyro_xyz_rps (&bno_data[sensor_id].gyro);
+	rslt_bno[sensor_id] = status;
 
 	if(!rslt_bno[sensor_id])
 	{
-		can_setFrame((int32_t) bno_data[sensor_id].accel.x, DATA_ID_ACCELERATION_X, HAL_GetTick());
-		can_setFrame((int32_t) bno_data[sensor_id].accel.y, DATA_ID_ACCELERATION_Y, HAL_GetTick());
-		can_setFrame((int32_t) bno_data[sensor_id].accel.z, DATA_ID_ACCELERATION_Z, HAL_GetTick());
-		can_setFrame((int32_t)(1000*bno_data[sensor_id].gyro.x), DATA_ID_GYRO_X, HAL_GetTick());
-		can_setFrame((int32_t)(1000*bno_data[sensor_id].gyro.y), DATA_ID_GYRO_Y, HAL_GetTick());
-		can_setFrame((int32_t)(1000*bno_data[sensor_id].gyro.z), DATA_ID_GYRO_Z, HAL_GetTick());
+		bno_data[sensor_id].accel.x = bno_axis(raw + 0) / BNO055_ACCEL_DIV_MG;
+		bno_data[sensor_id].accel.y = bno_axis(raw + 2) / BNO055_ACCEL_DIV_MG;
+		bno_data[sensor_id].accel.z = bno_axis(raw + 4) / BNO055_ACCEL_DIV_MG;
+		bno_data[sensor_id].mag.x = bno_axis(raw + 6) / (float) BNO055_MAG_DIV_UT;
+		bno_data[sensor_id].mag.y = bno_axis(raw + 8) / (float) BNO055_MAG_DIV_UT;
+		bno_data[sensor_id].mag.z = bno_axis(raw + 10) / (float) BNO055_MAG_DIV_UT;
+		bno_data[sensor_id].gyro.x = bno_axis(raw + 12) / (float) BNO055_GYRO_DIV_RPS;
+		bno_data[sensor_id].gyro.y = bno_axis(raw + 14) / (float) BNO055_GYRO_DIV_RPS;
+		bno_data[sensor_id].gyro.z = bno_axis(raw + 16) / (float) BNO055_GYRO_DIV_RPS;
+
 		if(!cntr)
 		{
-			sprintf(buf, "Accel: [%f, %f, %f]\n", bno_data[sensor_id].accel.x, bno_data[sensor_id].accel.y, bno_data[sensor_id].accel.z);
+			//sprintf(buf, "Accel: [%f, %f, %f]\n", (double) bno_data[sensor_id].accel.x, (double) bno_data[sensor_id].accel.y, (double) bno_data[sensor_id].accel.z);
 			//INFO(buf);
-			sprintf(buf, "Gyro: [%f, %f, %f]\n", bno_data[sensor_id].gyro.x, bno_data[sensor_id].gyro.y, bno_data[sensor_id].gyro.z);
+			//sprintf(buf, "Gyro: [%f, %f, %f]\n", (double) bno_data[sensor_id].gyro.x, (double) bno_data[sensor_id].gyro.y, (double) bno_data[sensor_id].gyro.z);
 			//INFO(buf);
-			sprintf(buf, "Mag: [%f, %f, %f]\n\n\n", bno_data[sensor_id].mag.x, bno_data[sensor_id].mag.y, bno_data[sensor_id].mag.z);
+			//sprintf(buf, "Mag: [%f, %f, %f]\n\n\n", (double) bno_data[sensor_id].mag.x, (double) bno_data[sensor_id].mag.y, (double) bno_data[sensor_id].mag.z);
 			//INFO(buf);
 		}
 	}
@@ -353,34 +761,41 @@ int8_t fetch_bno(uint8_t sensor_id, int8_t rslt_bno[MAX_SENSOR_NUMBER])
  * I2C3 : Sensor 0 and Sensor 1
  * FMPI2C1 : Sensor 2 and Sensor 3
  *
+ * Only the sensor board task waits for the transfer, the scheduler keeps running (see sensor_i2c.c).
  */
 
 int8_t stm32_i2c_read (uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len)
 {
-	vTaskSuspendAll();
-	int8_t rslt = 0;
-	if (sensor_id == 0 || sensor_id == 1) {
-		rslt = HAL_I2C_Mem_Read(&hi2c3, dev_id << 1, reg_addr, I2C_MEMADD_SIZE_8BIT, data, len, I2C_TIMEOUT);
-	}
-	else if (sensor_id == 2 || sensor_id == 3) {
-		rslt = HAL_FMPI2C_Mem_Read(&hfmpi2c1, dev_id << 1, reg_addr, FMPI2C_MEMADD_SIZE_8BIT, data, len, FMPI2C_TIMEOUT);
-	}
-	xTaskResumeAll();
-	return rslt;
+	return sensor_i2c_read(sensor_id, dev_id, reg_addr, data, len);
 }
 
 int8_t stm32_i2c_write (uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len)
 {
-	vTaskSuspendAll();
-	int8_t rslt = 0;
-	if (sensor_id == 0 || sensor_id == 1) {
-		rslt = HAL_I2C_Mem_Write(&hi2c3, dev_id << 1, reg_addr, I2C_MEMADD_SIZE_8BIT, data, len, I2C_TIMEOUT);
-	}
-	else if (sensor_id == 2 || sensor_id == 3) {
-		rslt = HAL_FMPI2C_Mem_Write(&hfmpi2c1, dev_id << 1, reg_addr, FMPI2C_MEMADD_SIZE_8BIT, data, len, FMPI2C_TIMEOUT);
-	}
-	xTaskResumeAll();
-	return rslt;
+	return sensor_i2c_write(sensor_id, dev_id, reg_addr, data, len);
+}
+
+/*
+ * Bus functions of the drivers, which only pass the I2C address: same address on both buses
+ */
+
+int8_t bme_i2c_read (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+	return stm32_i2c_read(driver_sensor_id, dev_id, reg_addr, data, len);
+}
+
+int8_t bme_i2c_write (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len)
+{
+	return stm32_i2c_write(driver_sensor_id, dev_id, reg_addr, data, len);
+}
+
+int8_t bno_i2c_read (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint8_t len)
+{
+	return stm32_i2c_read(driver_sensor_id, dev_id, reg_addr, data, len);
+}
+
+int8_t bno_i2c_write (uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint8_t len)
+{
+	return stm32_i2c_write(driver_sensor_id, dev_id, reg_addr, data, len);
 }
 
 void stm32_delay_ms (uint32_t delay)
@@ -388,276 +803,203 @@ void stm32_delay_ms (uint32_t delay)
 	osDelay(delay);
 }
 
+#ifdef NUMERICS_BENCHMARK
 /*
- * sensor_elimination :
- *
- * Used to compare the data from the different sensors
- *
- * Input Arguments :
- *  - values from the different sensors
- *  - correct value determined by the algorithm
- *  - array of size MAX_SENSOR_NUMBER to know if there was an initialization or
- *    fetch error
- *
- * If sensor_elimination_4 finds an erroneous sensor, its values are not taken into
- * account and sensor_elimination_3 takes over. Indeed, the intervals of confidence
- * calculated by sensor_elimination _4 might have been corrupted by the erroneous sensor,
- * therefore new intervals have to be calculated.
- *
+ * Logs the average cycle count of the altitude, computed in single precision and as it
+ * was in double precision through the software double routines of the Cortex-M4F, and
+ * of the vote of the IMU data of 4 sensors, one of them off, as vectors and axis by axis.
  */
-
-void sensor_elimination_4(float value_0, float value_1, float value_2, float value_3, float *correct_value, bool erroneous_sensor[MAX_SENSOR_NUMBER]) {
-	float value[MAX_SENSOR_NUMBER] = {value_0, value_1, value_2, value_3};
-	if (!erroneous_sensor[0]) { // Checking if one of the sensor has been eliminated before
-		if (!erroneous_sensor[1]) {
-			if (!erroneous_sensor[2]) {
-				if (!erroneous_sensor[3]) {
-					if (within_conf_interval_4(value_0, value_1, value_2, value_3)) { // If all sensors are working properly so far, we check the confidence intervals
-						if (within_conf_interval_4(value_1, value_0, value_2, value_3)) {
-							if (within_conf_interval_4(value_2, value_0, value_1, value_3)) {
-								if (within_conf_interval_4(value_3, value_1, value_2, value_0)) {
-									*correct_value = (value_0 + value_1 + value_2 + value_3)/MAX_SENSOR_NUMBER;
-								}
-								else { // Value_3 out, redundancy on the 3 sensors left
-									sensor_elimination_3(value, 0, 1, 2, correct_value, erroneous_sensor);
-								}
-							}
-							else { // Value_2 out
-								sensor_elimination_3(value, 0, 1, 3, correct_value, erroneous_sensor);
-							}
-						}
-						else { // value_1 out
-							sensor_elimination_3(value, 0, 2, 3, correct_value, erroneous_sensor);
-						}
-					}
-					else { // value_0 out
-						sensor_elimination_3(value, 1, 2, 3, correct_value, erroneous_sensor);
-					}
-				}
-				else { // Value_3 not fetched, redundancy on the 3 sensors left
-					sensor_elimination_3(value, 0, 1, 2, correct_value, erroneous_sensor);
-				}
-			}
-			else { // Value_2 not fetched
-				sensor_elimination_3(value, 0, 1, 3, correct_value, erroneous_sensor);
-			}
-		}
-		else { // value_1 not fetched
-			sensor_elimination_3(value, 0, 2, 3, correct_value, erroneous_sensor);
-		}
-	}
-	else { // value_0 not fetched
-		sensor_elimination_3(value, 1, 2, 3, correct_value, erroneous_sensor);
-	}
-}
-
-void sensor_elimination_3(float value[MAX_SENSOR_NUMBER], uint8_t index_0, uint8_t index_1, uint8_t index_2, float *correct_value, bool erroneous_sensor[MAX_SENSOR_NUMBER]) {
-	if (!erroneous_sensor[index_0]) { // Checking if one of the sensor has been eliminated before
-		if (!erroneous_sensor[index_1]) {
-			if (!erroneous_sensor[index_2]) {
-				if (within_conf_interval_3(value[index_0], value[index_1], value[index_2])) { // If all sensors are working properly so far, we check the confidence intervals
-					if (within_conf_interval_3(value[index_1], value[index_0], value[index_2])) {
-						if (within_conf_interval_3(value[index_2], value[index_1], value[index_0])) {
-							*correct_value = (value[index_0] + value[index_1] + value[index_2])/(MAX_SENSOR_NUMBER-1);
-						}
-						else { // Value_2 out, no redundancy on the 2 sensors left
-							*correct_value = (value[index_0] + value[index_1])/(MAX_SENSOR_NUMBER-2);
-						}
-					}
-					else { // Value_1 out
-						*correct_value = (value[index_0] + value[index_2])/(MAX_SENSOR_NUMBER-2);
-					}
-				}
-				else { // Value_0 out
-					*correct_value = (value[index_1] + value[index_2])/(MAX_SENSOR_NUMBER-2);
-				}
-			}
-			else { // Value_2 not fetched
-				sensor_elimination_2(value, index_0, index_1, correct_value, erroneous_sensor);
-			}
+void sensor_benchmarkNumerics(void) {
+	const uint32_t runs = 1000;
+	static const float tolerance[BNO_VOTE_KINDS] = {BNO_ACCEL_TOLERANCE, BNO_GYRO_TOLERANCE};
+	static const float axis_tolerance[3 * BNO_VOTE_KINDS] = {BNO_ACCEL_TOLERANCE, BNO_ACCEL_TOLERANCE, BNO_ACCEL_TOLERANCE,
+			BNO_GYRO_TOLERANCE, BNO_GYRO_TOLERANCE, BNO_GYRO_TOLERANCE};
+	static const Vote_vectors vectors[BNO_VOTE_KINDS] = {
+			{{12.0f, 15.0f, 9.0f, 2000.0f}, {-3.0f, 1.0f, -1.0f, -3.0f}, {1002.0f, 998.0f, 1005.0f, 1001.0f}},
+			{{0.011f, 0.014f, 0.009f, 0.012f}, {-0.020f, -0.018f, -0.023f, 1.500f}, {0.003f, 0.001f, 0.004f, 0.002f}}};
+	const bool valid[MAX_SENSOR_NUMBER] = {true, true, true, true};
+	float axes[MAX_SENSOR_NUMBER][3 * BNO_VOTE_KINDS];
+	volatile float pressure = 950.0f;
+	volatile float altitude;
+	Vote_vector correct[BNO_VOTE_KINDS];
+	float axis_correct[3 * BNO_VOTE_KINDS];
+	bool rejected[MAX_SENSOR_NUMBER], axis_rejected[MAX_SENSOR_NUMBER];
+	uint32_t float_altitude_cycles = 0, double_altitude_cycles = 0, vector_cycles = 0, axis_cycles = 0;
+
+	for (uint8_t i = 0; i < MAX_SENSOR_NUMBER; i++) {
+		for (uint8_t kind = 0; kind < BNO_VOTE_KINDS; kind++) {
+			axes[i][3 * kind] = vectors[kind].x[i];
+			axes[i][3 * kind + 1] = vectors[kind].y[i];
+			axes[i][3 * kind + 2] = vectors[kind].z[i];
 		}
-		else { // Value_1 not fetched
-			sensor_elimination_2(value, index_0, index_2, correct_value, erroneous_sensor);
-		}
-	}
-	else { // Value_0 not fetched
-		sensor_elimination_2(value, index_1, index_2, correct_value, erroneous_sensor);
 	}
-}
 
-void sensor_elimination_2(float value[MAX_SENSOR_NUMBER], uint8_t index_0, uint8_t index_1, float *correct_value, bool erroneous_sensor[MAX_SENSOR_NUMBER]) {
-	if (!erroneous_sensor[index_0]) { // Checking if one of the sensor has been eliminated before
-		if (!erroneous_sensor[index_1]) {
-			*correct_value = (value[index_0] + value[index_1])/(MAX_SENSOR_NUMBER-2);
-		}
-	}
-	else {
-		if (!erroneous_sensor[index_1]) {
-			*correct_value = value[index_1]/(MAX_SENSOR_NUMBER-3);
-		}
-		else { } // If no sensors are fetched, correct_value doesn't change
-	}
-}
+	profiler_init();
 
-/*
- * within_conf_interval
- *
- * Checks if the FIRST GIVEN ARGUMENT is included inside [-3*sigma;+3*sigma]
- * of the normal distribution for a 99% confidence interval
- * The normal distribution is baised on the values of the two or three other
- * sensors
- *
- */
+	for (uint32_t i = 0; i < runs; i++) {
+		uint32_t start = profiler_cycles();
+		altitude = altitudeFromPressure(pressure);
+		float_altitude_cycles += profiler_cycles() - start;
 
+		start = profiler_cycles();
+		altitude = (float) (44330 * (1.0 - pow ((double) pressure / (double) ADJUSTED_SEA_LEVEL_PRESSURE, 0.1903)));
+		double_altitude_cycles += profiler_cycles() - start;
 
-bool within_conf_interval_4(float data_0, float data_1, float data_2, float data_3) {
-	if (data_1 != data_2 && data_1 != data_3 && data_2 != data_3) {
-		float mean = (data_1 + data_2 + data_3)/(MAX_SENSOR_NUMBER-1);
-		float std_dev = sqrt( pow(data_1 - mean,2) + pow(data_2 - mean,2) + pow(data_3 - mean,2) );
-		float normal_data_0 = (data_0 - mean)/std_dev;
-		return ( -normal_coef < normal_data_0 && normal_coef > normal_data_0 );
-	}
-	else { return false; }
-}
+		start = profiler_cycles();
+		sensor_vote_vectors(vectors, BNO_VOTE_KINDS, MAX_SENSOR_NUMBER, valid, tolerance, correct, rejected);
+		vector_cycles += profiler_cycles() - start;
 
-bool within_conf_interval_3(float data_0, float data_1, float data_2) {
-	if (data_1 != data_2) { // If two values are equal, returns their shared value
-		float mean = (data_1 + data_2)/(MAX_SENSOR_NUMBER-2);
-		float std_dev = sqrt( pow(data_1 - mean,2) + pow(data_2 - mean,2) );
-		float normal_data_0 = (data_0 - mean)/std_dev;
-		return ( -normal_coef < normal_data_0 && normal_coef > normal_data_0 );
+		start = profiler_cycles();
+		sensor_vote(&axes[0][0], MAX_SENSOR_NUMBER, 3 * BNO_VOTE_KINDS, valid, axis_tolerance, axis_correct, axis_rejected);
+		axis_cycles += profiler_cycles() - start;
 	}
-	else { return false; }
+
+	(void) altitude;
+	rocket_log("altitude: %ld cycles in float, %ld in double\n",
+			float_altitude_cycles / runs, double_altitude_cycles / runs);
+	rocket_log("IMU vote of %d sensors: %ld cycles as vectors, %ld axis by axis, sensor 3 rejected: %d\n",
+			MAX_SENSOR_NUMBER, vector_cycles / runs, axis_cycles / runs, rejected[3]);
 }
+#endif
 
 /*
  * XXX_redundancy
  *
- * Calls the redundancy algorithm for each kind of data given by the sensors
+ * Votes each kind of data given by the sensors acquired and fetched in this cycle, and
+ * flags the sensors whose data was discarded.
+ * Returns the number of sensors that voted: the correct data is left unchanged when
+ * there is none. An IMU is kept or discarded for all its data at once.
  *
  */
 
-void bno_redundancy(int8_t rslt_bno[MAX_SENSOR_NUMBER]) {
-	bool erroneous_bno[MAX_SENSOR_NUMBER] = {false};
+uint8_t bno_redundancy(uint8_t imu_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], bool rejected[MAX_SENSOR_NUMBER]) {
+	static const float tolerance[BNO_VOTE_KINDS] = {BNO_ACCEL_TOLERANCE, BNO_GYRO_TOLERANCE};
+	Vote_vectors vectors[BNO_VOTE_KINDS]; // accel then gyro
+	Vote_vector correct[BNO_VOTE_KINDS];
+	bool fetched[MAX_SENSOR_NUMBER];
+
 	for (uint8_t i = 0; i<MAX_SENSOR_NUMBER; i++) {
-		erroneous_bno[i] = rslt_bno[i]; // If the sensor hasn't been fetched, we can't have a rogue value
+		fetched[i] = imu_active[i] && !rslt_bno[i]; // If the sensor hasn't been fetched, we can't have a rogue value
+		vectors[0].x[i] = bno_data[i].accel.x;
+		vectors[0].y[i] = bno_data[i].accel.y;
+		vectors[0].z[i] = bno_data[i].accel.z;
+		vectors[1].x[i] = bno_data[i].gyro.x;
+		vectors[1].y[i] = bno_data[i].gyro.y;
+		vectors[1].z[i] = bno_data[i].gyro.z;
+	}
+
+	uint8_t voters = sensor_vote_vectors(vectors, BNO_VOTE_KINDS, MAX_SENSOR_NUMBER, fetched, tolerance, correct, rejected);
+	if (voters) {
+		correct_bno_data.accel.x = correct[0].x;
+		correct_bno_data.accel.y = correct[0].y;
+		correct_bno_data.accel.z = correct[0].z;
+		correct_bno_data.gyro.x = correct[1].x;
+		correct_bno_data.gyro.y = correct[1].y;
+		correct_bno_data.gyro.z = correct[1].z;
 	}
-	sensor_elimination_4(bno_data[0].accel.x, bno_data[1].accel.x, bno_data[2].accel.x, bno_data[3].accel.x, &correct_bno_data.accel.x, erroneous_bno); // Attention ! Il faut toujours que les baros soient appelés par ordre d'indice croissant !
-	sensor_elimination_4(bno_data[0].accel.y, bno_data[1].accel.y, bno_data[2].accel.y, bno_data[3].accel.y, &correct_bno_data.accel.y, erroneous_bno);
-	sensor_elimination_4(bno_data[0].accel.z, bno_data[1].accel.z, bno_data[2].accel.z, bno_data[3].accel.z, &correct_bno_data.accel.z, erroneous_bno);
-	sensor_elimination_4(bno_data[0].gyro.x, bno_data[1].gyro.x, bno_data[2].gyro.x, bno_data[3].gyro.x, &correct_bno_data.gyro.x, erroneous_bno);
-	sensor_elimination_4(bno_data[0].gyro.y, bno_data[1].gyro.y, bno_data[2].gyro.y, bno_data[3].gyro.y, &correct_bno_data.gyro.y, erroneous_bno);
-	sensor_elimination_4(bno_data[0].gyro.z, bno_data[1].gyro.z, bno_data[2].gyro.z, bno_data[3].gyro.z, &correct_bno_data.gyro.z, erroneous_bno);
+	return voters;
 }
 
-void bme_redundancy(int8_t rslt_bme[MAX_SENSOR_NUMBER]) {
-	bool erroneous_bme[MAX_SENSOR_NUMBER] = {false};
+uint8_t bme_redundancy(uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], bool rejected[MAX_SENSOR_NUMBER]) {
+	static const float tolerance[BME_VOTE_AXES] = {BME_PRESSURE_TOLERANCE, BME_TEMPERATURE_TOLERANCE};
+	float values[MAX_SENSOR_NUMBER][BME_VOTE_AXES];
+	float correct[BME_VOTE_AXES];
+	bool fetched[MAX_SENSOR_NUMBER];
+
 	for (uint8_t i = 0; i<MAX_SENSOR_NUMBER; i++) {
-			erroneous_bme[i] = rslt_bme[i];
+		fetched[i] = baro_active[i] && !rslt_bme[i];
+		values[i][0] = bme_data_float[i].pressure;
+		values[i][1] = bme_data_float[i].temperature;
 	}
-	sensor_elimination_4(bme_data_float[0].pressure, bme_data_float[1].pressure, bme_data_float[2].pressure, bme_data_float[3].pressure, &correct_bme_data.pressure, erroneous_bme);
-	sensor_elimination_4(bme_data_float[0].temperature, bme_data_float[1].temperature, bme_data_float[2].temperature, bme_data_float[3].temperature, &correct_bme_data.temperature,erroneous_bme);
+
+	uint8_t voters = sensor_vote(&values[0][0], MAX_SENSOR_NUMBER, BME_VOTE_AXES, fetched, tolerance, correct, rejected);
+	if (voters) {
+		// the conversions read in a cycle are usually triggered together, averaged as ages against overflows
+		uint32_t age = 0, kept = 0;
+		for (uint8_t i = 0; i<MAX_SENSOR_NUMBER; i++) {
+			if (fetched[i] && !rejected[i]) {
+				age += sample_timestamp - bme_data_float[i].timestamp;
+				kept++;
+			}
+		}
+
+		correct_bme_data.pressure = correct[0];
+		correct_bme_data.temperature = correct[1];
+		correct_bme_data.timestamp = sample_timestamp - (kept ? age / kept : 0);
+	}
+	return voters;
 }
 
 /*
  * XXX_data_process
  *
- * Used to send the sensors data through the can, whether there was a redundancy or not.
- * No redundancy means that only one sensor has been initialized/fetched, its values are then sent.
+ * Used to vote the sensors data, whatever the number of sensors fetched, for send_sample.
+ * With a single sensor fetched, the vote gives its values. Returns whether there was a vote.
  *
  */
 
 
-void bme_data_process(uint8_t baro_init[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], uint8_t cntr)
+bool bme_data_process(uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER], uint8_t cntr, bool rejected[MAX_SENSOR_NUMBER])
 {
-	if ( baro_init[0] || baro_init[1] || baro_init[2] || baro_init[3] )
-	{ // Checks if at least one BME is initialized
-		if(cntr>0)
+	if (cntr > 0 && bme_redundancy(baro_active, rslt_bme, rejected))
+	{ // At least one BME acquired and fetched
+		if (!correct_bme_calibrated)
 		{
-			if ( (!rslt_bme[0] && !rslt_bme[1]) || (!rslt_bme[1] && !rslt_bme[2]) || (!rslt_bme[0] && !rslt_bme[2]) ||
-				 (!rslt_bme[0] && !rslt_bme[3]) || (!rslt_bme[1] && !rslt_bme[3]) || (!rslt_bme[2] && !rslt_bme[3]))
-			{ // Checks if at least two barometers have correctly been fetched
-
-				bme_redundancy(rslt_bme);
-				if (!correct_bme_calibrated)
-				{
-					correct_bme_basepressure += correct_bme_data.pressure/100;
-					correct_bme_calib_counter++;
-					if (correct_bme_calib_counter == BARO_CALIB_N)
-					{
-						correct_bme_basepressure /= BARO_CALIB_N;
-						correct_bme_calibrated = true;
-					}
-				}
-				if (cntr==1)
-				{
-						can_setFrame(correct_bme_basepressure, DATA_ID_CALIB_PRESSURE, HAL_GetTick());
-				}
-				can_setFrame(correct_bme_data.temperature, DATA_ID_TEMPERATURE, HAL_GetTick());
-				can_setFrame(correct_bme_data.pressure/100, DATA_ID_PRESSURE, HAL_GetTick());
-			}
-
-			else { // No BME redundancy
-				for (uint8_t i = 0; i<3; i++) {
-					if (!rslt_bme[i])
-					{
-						if (!correct_bme_calibrated)
-						{
-							correct_bme_basepressure += bme_data_float[i].pressure/100;
-							correct_bme_calib_counter++;
-							if (correct_bme_calib_counter == BARO_CALIB_N)
-							{
-								correct_bme_basepressure /= BARO_CALIB_N;
-								correct_bme_calibrated = true;
-							}
-						}
-						if (cntr==1)
-						{
-							can_setFrame(correct_bme_basepressure, DATA_ID_CALIB_PRESSURE, HAL_GetTick()); // Still needs the ID of the correct data for the CanBus to recognize it
-						}
-						can_setFrame(bme_data_float[i].temperature, DATA_ID_TEMPERATURE, HAL_GetTick());
-						can_setFrame(bme_data_float[i].pressure/100, DATA_ID_PRESSURE, HAL_GetTick());
-					}
-				}
+			correct_bme_basepressure += correct_bme_data.pressure/100;
+			correct_bme_calib_counter++;
+			if (correct_bme_calib_counter == BARO_CALIB_N)
+			{
+				correct_bme_basepressure /= BARO_CALIB_N;
+				correct_bme_calibrated = true;
 			}
 		}
+		return true;
 	}
+	return false;
 }
 
-void bno_data_process(uint8_t imu_init[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], uint8_t cntr)
+bool bno_data_process(uint8_t imu_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], uint8_t cntr, bool rejected[MAX_SENSOR_NUMBER])
 {
-	if ( imu_init[0] || imu_init[1] || imu_init[2] || imu_init[3] )
-	{ // Checks if at least one BNO is initialized
-		if(cntr>0)
-		{
-			if ( (!rslt_bno[0] && !rslt_bno[1]) || (!rslt_bno[1] && !rslt_bno[2]) || (!rslt_bno[0] && !rslt_bno[2]) ||
-				 (!rslt_bno[0] && !rslt_bno[3]) || (!rslt_bno[1] && !rslt_bno[3]) || (!rslt_bno[2] && !rslt_bno[3]))
-			{ // Checks if at least two IMU have correctly been fetched
-
-				bno_redundancy(rslt_bno);
-				can_setFrame((int32_t) correct_bno_data.accel.x, DATA_ID_ACCELERATION_X, HAL_GetTick());
-				can_setFrame((int32_t) correct_bno_data.accel.y, DATA_ID_ACCELERATION_Y, HAL_GetTick());
-				can_setFrame((int32_t) correct_bno_data.accel.z, DATA_ID_ACCELERATION_Z, HAL_GetTick());
-				can_setFrame((int32_t)(1000*correct_bno_data.gyro.x), DATA_ID_GYRO_X, HAL_GetTick());
-				can_setFrame((int32_t)(1000*correct_bno_data.gyro.y), DATA_ID_GYRO_Y, HAL_GetTick());
-				can_setFrame((int32_t)(1000*correct_bno_data.gyro.z), DATA_ID_GYRO_Z, HAL_GetTick());
-			}
+	return cntr > 0 && bno_redundancy(imu_active, rslt_bno, rejected);
+}
 
-			else
-			{ // No BNO redundancy
-				for (uint8_t i = 0; i<3; i++)
-				{
-					if (!rslt_bno[i])
-					{
-						can_setFrame((int32_t) bno_data[i].accel.x, DATA_ID_ACCELERATION_X, HAL_GetTick());
-						can_setFrame((int32_t) bno_data[i].accel.y, DATA_ID_ACCELERATION_Y, HAL_GetTick());
-						can_setFrame((int32_t) bno_data[i].accel.z, DATA_ID_ACCELERATION_Z, HAL_GetTick());
-						can_setFrame((int32_t)(1000*bno_data[i].gyro.x), DATA_ID_GYRO_X, HAL_GetTick());
-						can_setFrame((int32_t)(1000*bno_data[i].gyro.y), DATA_ID_GYRO_Y, HAL_GetTick());
-						can_setFrame((int32_t)(1000*bno_data[i].gyro.z), DATA_ID_GYRO_Z, HAL_GetTick());
-					}
-				}
-			}
+/*
+ * The frames of a sample, from the first ID given: the IMU ones end with the gyro y and z,
+ * on which the receivers take the IMU data.
+ */
+
+static void send_imu_frames(const struct bno055_data* data, uint8_t first_id)
+{
+	can_setFrame(can_packHalves((int32_t) data->accel.x, (int32_t) data->accel.y), first_id, sample_timestamp);
+	can_setFrame(can_packHalves((int32_t) data->accel.z, (int32_t) (1000 * data->gyro.x)), first_id + 1, sample_timestamp);
+	can_setFrame(can_packHalves((int32_t) (1000 * data->gyro.y), (int32_t) (1000 * data->gyro.z)), first_id + 2, sample_timestamp);
+}
+
+static void send_baro_frame(const struct bme280_data_float* data, uint8_t id)
+{
+	can_setFrame(can_packBaro((int32_t) data->pressure, (int32_t) data->temperature), id, data->timestamp);
+}
+
+void send_sample(bool imu, bool baro)
+{
+	if (imu) {
+		send_imu_frames(&correct_bno_data, DATA_ID_SAMPLE_ACCEL_XY);
+	}
+	if (baro) {
+		send_baro_frame(&correct_bme_data, DATA_ID_SAMPLE_BARO);
+	}
+}
+
+void send_raw_samples(uint8_t imu_active[MAX_SENSOR_NUMBER], uint8_t baro_active[MAX_SENSOR_NUMBER], int8_t rslt_bno[MAX_SENSOR_NUMBER], int8_t rslt_bme[MAX_SENSOR_NUMBER])
+{
+	for (uint8_t sensor_id = 0; sensor_id < MAX_SENSOR_NUMBER; sensor_id++) {
+		uint8_t first_id = DATA_ID_RAW_SAMPLE + DATA_ID_SAMPLE_FRAMES * sensor_id;
+
+		if (imu_active[sensor_id] && !rslt_bno[sensor_id]) {
+			send_imu_frames(&bno_data[sensor_id], first_id);
+		}
+		if (baro_active[sensor_id] && !rslt_bme[sensor_id]) {
+			send_baro_frame(&bme_data_float[sensor_id], first_id + DATA_ID_SAMPLE_BARO - DATA_ID_SAMPLE_ACCEL_XY);
 		}
 	}
 }
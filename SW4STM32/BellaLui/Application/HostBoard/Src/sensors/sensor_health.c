@@ -0,0 +1,95 @@
+/*
+ * sensor_health.c
+ *
+ * Plain state machines, timed by the caller: the sensor board decides what a fault is
+ * and when to re-initialise a sensor.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_health.h>
+
+static void exclude(Sensor_health_tracker* h, uint32_t now) {
+	h->state = SENSOR_HEALTH_EXCLUDED;
+	h->excluded_at = now;
+}
+
+void health_init(Sensor_health_tracker* h) {
+	h->state = SENSOR_HEALTH_REPROBING;
+	h->faults = 0;
+	h->passes = 0;
+	h->excluded_at = 0;
+	h->probe_interval_ms = HEALTH_PROBE_INTERVAL_MS;
+}
+
+bool health_isAcquired(const Sensor_health_tracker* h) {
+	return h->state == SENSOR_HEALTH_GOOD || h->state == SENSOR_HEALTH_SUSPECT;
+}
+
+void health_update(Sensor_health_tracker* h, bool fault, uint32_t now) {
+	switch(h->state) {
+	case SENSOR_HEALTH_GOOD:
+		if(fault) {
+			h->state = SENSOR_HEALTH_SUSPECT;
+			h->faults = 1;
+			h->passes = 0;
+		}
+		break;
+	case SENSOR_HEALTH_SUSPECT:
+		if(fault) {
+			h->passes = 0;
+
+			if(++h->faults >= HEALTH_EXCLUDE_FAULTS) {
+				exclude(h, now);
+			}
+		} else if(++h->passes >= HEALTH_RECOVER_PASSES) {
+			h->state = SENSOR_HEALTH_GOOD;
+			h->probe_interval_ms = HEALTH_PROBE_INTERVAL_MS;
+		}
+		break;
+	default: // not acquired
+		break;
+	}
+}
+
+bool health_probeDue(Sensor_health_tracker* h, uint32_t now) {
+	if(h->state == SENSOR_HEALTH_REPROBING) {
+		return true;
+	}
+
+	if(h->state == SENSOR_HEALTH_EXCLUDED && now - h->excluded_at >= h->probe_interval_ms) {
+		h->state = SENSOR_HEALTH_REPROBING;
+
+		if(h->probe_interval_ms < HEALTH_PROBE_INTERVAL_MAX_MS) {
+			h->probe_interval_ms *= 2;
+		}
+
+		return true;
+	}
+
+	return false;
+}
+
+void health_probed(Sensor_health_tracker* h, bool success, uint32_t now) {
+	if(h->state != SENSOR_HEALTH_REPROBING) {
+		return;
+	}
+
+	if(success) {
+		h->state = SENSOR_HEALTH_SUSPECT;
+		h->faults = 0;
+		h->passes = 0;
+	} else {
+		exclude(h, now);
+	}
+}
+
+uint32_t health_pack(const Sensor_health_tracker* h, uint8_t count) {
+	uint32_t packed = 0;
+
+	for(uint8_t i = 0; i < count; i++) {
+		packed |= (uint32_t) h[i].state << (HEALTH_BITS * i);
+	}
+
+	return packed;
+}
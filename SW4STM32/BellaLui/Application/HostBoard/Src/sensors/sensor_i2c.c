@@ -0,0 +1,243 @@
+/*
+ * sensor_i2c.c
+ *
+ * Reads of I2C3 run on its DMA stream, the other transfers on interrupts: FMPI2C1 and
+ * the writes of I2C3 have no DMA stream assigned. The completion and error callbacks
+ * flag the bus and notify the task that started the transaction.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_i2c.h>
+
+#include <stdbool.h>
+#include <stm32f4xx_hal.h>
+#include <cmsis_os.h>
+
+#define SENSOR_I2C_IRQ_PRIORITY 5 // configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, highest allowed to give a semaphore
+
+extern I2C_HandleTypeDef hi2c3;
+extern FMPI2C_HandleTypeDef hfmpi2c1;
+
+struct Bus {
+	SemaphoreHandle_t lock; // one transaction at a time on the bus, from its start to its end
+	volatile TaskHandle_t owner; // notified by the callbacks
+	volatile bool done;
+	volatile int8_t result;
+};
+
+static struct Bus buses[SENSOR_I2C_BUSES];
+
+
+void sensor_i2c_init() {
+	for(int i = 0; i < SENSOR_I2C_BUSES; i++) {
+		buses[i].lock = xSemaphoreCreateMutex();
+	}
+
+	HAL_NVIC_SetPriority(I2C3_EV_IRQn, SENSOR_I2C_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(I2C3_EV_IRQn);
+	HAL_NVIC_SetPriority(I2C3_ER_IRQn, SENSOR_I2C_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(I2C3_ER_IRQn);
+	HAL_NVIC_SetPriority(FMPI2C1_EV_IRQn, SENSOR_I2C_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(FMPI2C1_EV_IRQn);
+	HAL_NVIC_SetPriority(FMPI2C1_ER_IRQn, SENSOR_I2C_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(FMPI2C1_ER_IRQn);
+}
+
+enum Sensor_i2c_bus sensor_i2c_bus(uint8_t sensor_id) {
+	return sensor_id < 2 ? SENSOR_I2C_BUS_I2C3 : SENSOR_I2C_BUS_FMPI2C1;
+}
+
+/*
+ * Back to a ready peripheral after a transaction that never completed, which would
+ * otherwise leave its handle busy for good.
+ */
+static void reset_bus(enum Sensor_i2c_bus id) {
+	if(id == SENSOR_I2C_BUS_I2C3) {
+		HAL_I2C_DeInit(&hi2c3);
+		HAL_I2C_Init(&hi2c3);
+	} else {
+		HAL_FMPI2C_DeInit(&hfmpi2c1);
+		HAL_FMPI2C_Init(&hfmpi2c1);
+	}
+}
+
+static HAL_StatusTypeDef start(enum Sensor_i2c_bus id, bool read, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	HAL_StatusTypeDef rslt;
+
+	if(id == SENSOR_I2C_BUS_I2C3) {
+		if(read) {
+			rslt = HAL_I2C_Mem_Read_DMA(&hi2c3, dev_id << 1, reg_addr, I2C_MEMADD_SIZE_8BIT, data, len);
+
+			// a device that does not answer fails the address phase with the DMA stream already started
+			if(rslt != HAL_OK && hi2c3.hdmarx->State == HAL_DMA_STATE_BUSY) {
+				HAL_DMA_Abort(hi2c3.hdmarx);
+			}
+		} else {
+			rslt = HAL_I2C_Mem_Write_IT(&hi2c3, dev_id << 1, reg_addr, I2C_MEMADD_SIZE_8BIT, data, len);
+		}
+	} else {
+		if(read) {
+			rslt = HAL_FMPI2C_Mem_Read_IT(&hfmpi2c1, dev_id << 1, reg_addr, FMPI2C_MEMADD_SIZE_8BIT, data, len);
+		} else {
+			rslt = HAL_FMPI2C_Mem_Write_IT(&hfmpi2c1, dev_id << 1, reg_addr, FMPI2C_MEMADD_SIZE_8BIT, data, len);
+		}
+	}
+
+	return rslt;
+}
+
+static int8_t begin(uint8_t sensor_id, bool read, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	enum Sensor_i2c_bus id = sensor_i2c_bus(sensor_id);
+	struct Bus* bus = &buses[id];
+
+	xSemaphoreTake(bus->lock, portMAX_DELAY);
+
+	bus->done = false;
+	bus->owner = xTaskGetCurrentTaskHandle();
+
+	HAL_StatusTypeDef rslt = start(id, read, dev_id, reg_addr, data, len);
+
+	if(rslt != HAL_OK) {
+		bus->result = rslt;
+		bus->done = true;
+	}
+
+	return rslt;
+}
+
+int8_t sensor_i2c_start_read(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	return begin(sensor_id, true, dev_id, reg_addr, data, len);
+}
+
+int8_t sensor_i2c_start_write(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	return begin(sensor_id, false, dev_id, reg_addr, data, len);
+}
+
+uint32_t sensor_i2c_wait(uint32_t bus_mask, uint32_t timeout_ms) {
+	TickType_t start = xTaskGetTickCount();
+	TickType_t timeout = pdMS_TO_TICKS(timeout_ms);
+
+	for(;;) {
+		uint32_t over = 0;
+
+		for(int i = 0; i < SENSOR_I2C_BUSES; i++) {
+			if((bus_mask & (1 << i)) && buses[i].done) {
+				over |= 1 << i;
+			}
+		}
+
+		TickType_t elapsed = xTaskGetTickCount() - start;
+
+		if(over || elapsed >= timeout) {
+			return over;
+		}
+
+		// the flags tell which buses are over, the notification only wakes the task up
+		xTaskNotifyWait(0, UINT32_MAX, NULL, timeout - elapsed);
+	}
+}
+
+int8_t sensor_i2c_end(enum Sensor_i2c_bus id) {
+	struct Bus* bus = &buses[id];
+	int8_t rslt;
+
+	if(bus->done) {
+		rslt = bus->result;
+	} else {
+		reset_bus(id);
+		rslt = HAL_TIMEOUT;
+	}
+
+	bus->owner = NULL;
+	xSemaphoreGive(bus->lock);
+
+	return rslt;
+}
+
+static int8_t transaction(uint8_t sensor_id, bool read, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	enum Sensor_i2c_bus id = sensor_i2c_bus(sensor_id);
+
+	begin(sensor_id, read, dev_id, reg_addr, data, len);
+	sensor_i2c_wait(1 << id, SENSOR_I2C_TIMEOUT_MS);
+
+	return sensor_i2c_end(id);
+}
+
+int8_t sensor_i2c_read(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	return transaction(sensor_id, true, dev_id, reg_addr, data, len);
+}
+
+int8_t sensor_i2c_write(uint8_t sensor_id, uint8_t dev_id, uint8_t reg_addr, uint8_t *data, uint16_t len) {
+	return transaction(sensor_id, false, dev_id, reg_addr, data, len);
+}
+
+
+static void complete(enum Sensor_i2c_bus id, int8_t result) {
+	BaseType_t woken = pdFALSE;
+	TaskHandle_t owner = buses[id].owner;
+
+	buses[id].result = result;
+	buses[id].done = true;
+
+	if(owner != NULL) {
+		xTaskNotifyFromISR(owner, 1 << id, eSetBits, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
+
+void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if(hi2c == &hi2c3) {
+		complete(SENSOR_I2C_BUS_I2C3, HAL_OK);
+	}
+}
+
+void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c) {
+	if(hi2c == &hi2c3) {
+		complete(SENSOR_I2C_BUS_I2C3, HAL_OK);
+	}
+}
+
+void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c) {
+	if(hi2c == &hi2c3) {
+		complete(SENSOR_I2C_BUS_I2C3, HAL_ERROR);
+	}
+}
+
+void HAL_FMPI2C_MemRxCpltCallback(FMPI2C_HandleTypeDef *hfmpi2c) {
+	if(hfmpi2c == &hfmpi2c1) {
+		complete(SENSOR_I2C_BUS_FMPI2C1, HAL_OK);
+	}
+}
+
+void HAL_FMPI2C_MemTxCpltCallback(FMPI2C_HandleTypeDef *hfmpi2c) {
+	if(hfmpi2c == &hfmpi2c1) {
+		complete(SENSOR_I2C_BUS_FMPI2C1, HAL_OK);
+	}
+}
+
+void HAL_FMPI2C_ErrorCallback(FMPI2C_HandleTypeDef *hfmpi2c) {
+	if(hfmpi2c == &hfmpi2c1) {
+		complete(SENSOR_I2C_BUS_FMPI2C1, HAL_ERROR);
+	}
+}
+
+/*
+ * Not enabled in the CubeMX configuration: the vectors are set up by sensor_i2c_init.
+ * The DMA stream of I2C3 keeps its handler in stm32f4xx_it.c.
+ */
+void I2C3_EV_IRQHandler(void) {
+	HAL_I2C_EV_IRQHandler(&hi2c3);
+}
+
+void I2C3_ER_IRQHandler(void) {
+	HAL_I2C_ER_IRQHandler(&hi2c3);
+}
+
+void FMPI2C1_EV_IRQHandler(void) {
+	HAL_FMPI2C_EV_IRQHandler(&hfmpi2c1);
+}
+
+void FMPI2C1_ER_IRQHandler(void) {
+	HAL_FMPI2C_ER_IRQHandler(&hfmpi2c1);
+}
@@ -0,0 +1,132 @@
+/*
+ * sensor_sampling.c
+ *
+ * TIM7 is a basic timer unused by the CubeMX configuration: it is set up here, with its
+ * interrupt. The periods and latencies are measured with the cycle counter.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_sampling.h>
+
+#include <math.h>
+#include <stm32f4xx_hal.h>
+#include <cmsis_os.h>
+#include <debug/profiler.h>
+
+#define SAMPLING_IRQ_PRIORITY 5 // configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY, highest allowed to give a semaphore
+
+TIM_HandleTypeDef htim7;
+
+static SemaphoreHandle_t trigger_semaphore;
+
+// written by the interrupt
+static volatile uint32_t trigger_count = 0;
+static volatile uint32_t trigger_tick = 0;
+static volatile uint32_t trigger_cycles = 0;
+
+static uint32_t nominal_period_us = SAMPLING_PERIOD_US;
+static uint32_t acquired_count = 0;
+static uint32_t last_start_cycles = 0;
+static Sampling_stats stats;
+static float deviation_sum, deviation_square_sum; // [us], [us^2] from the nominal period
+
+
+void sampling_init() {
+	trigger_semaphore = xSemaphoreCreateBinary();
+}
+
+void sampling_start(uint32_t period_us) {
+	// timers of APB1 run at twice its clock when it is divided
+	uint32_t clock = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1) {
+		clock *= 2;
+	}
+
+	nominal_period_us = period_us;
+	profiler_init();
+
+	__HAL_RCC_TIM7_CLK_ENABLE();
+
+	htim7.Instance = TIM7;
+	htim7.Init.Prescaler = clock / 1000000 - 1; // 1 MHz
+	htim7.Init.CounterMode = TIM_COUNTERMODE_UP;
+	htim7.Init.Period = period_us - 1;
+	htim7.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+	HAL_TIM_Base_Init(&htim7);
+
+	HAL_NVIC_SetPriority(TIM7_IRQn, SAMPLING_IRQ_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(TIM7_IRQn);
+
+	HAL_TIM_Base_Start_IT(&htim7);
+}
+
+void sampling_wait(Sampling_trigger* trigger) {
+	xSemaphoreTake(trigger_semaphore, portMAX_DELAY);
+
+	uint32_t start = profiler_cycles();
+	uint32_t cycles_per_us = SystemCoreClock / 1000000;
+
+	taskENTER_CRITICAL();
+	uint32_t count = trigger_count;
+	trigger->timestamp = trigger_tick;
+	uint32_t latency_us = (start - trigger_cycles) / cycles_per_us;
+	taskEXIT_CRITICAL();
+
+	trigger->missed = acquired_count ? count - acquired_count - 1 : 0;
+	acquired_count = count;
+
+	if (latency_us > stats.latency_max_us) {
+		stats.latency_max_us = latency_us;
+	}
+	stats.missed += trigger->missed;
+
+	// a period spanning missed triggers is not a sampling period
+	if (last_start_cycles && !trigger->missed) {
+		int32_t period = (start - last_start_cycles) / cycles_per_us;
+		float deviation = (float) (period - (int32_t) nominal_period_us);
+
+		if (!stats.periods || period < stats.period_min_us) {
+			stats.period_min_us = period;
+		}
+		if (!stats.periods || period > stats.period_max_us) {
+			stats.period_max_us = period;
+		}
+
+		deviation_sum += deviation;
+		deviation_square_sum += deviation * deviation;
+		stats.periods++;
+	}
+
+	last_start_cycles = start;
+}
+
+void sampling_takeStats(Sampling_stats* s) {
+	if (stats.periods) {
+		float mean = deviation_sum / stats.periods;
+		float variance = deviation_square_sum / stats.periods - mean * mean;
+
+		stats.period_jitter_us = variance > 0 ? sqrtf(variance) : 0;
+	}
+
+	*s = stats;
+
+	stats = (Sampling_stats) { 0 };
+	deviation_sum = 0;
+	deviation_square_sum = 0;
+}
+
+void TIM7_IRQHandler(void) {
+	if (__HAL_TIM_GET_FLAG(&htim7, TIM_FLAG_UPDATE) != RESET) {
+		BaseType_t woken = pdFALSE;
+
+		__HAL_TIM_CLEAR_IT(&htim7, TIM_IT_UPDATE);
+
+		trigger_cycles = profiler_cycles();
+		trigger_tick = HAL_GetTick();
+		trigger_count++;
+
+		xSemaphoreGiveFromISR(trigger_semaphore, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+}
@@ -0,0 +1,166 @@
+/*
+ * sensor_vote.c
+ *
+ * The medians are taken by insertion sort on the stack: there are a few sensors only.
+ * The vectors are compared by their squared distances, whose median is the square of
+ * the median distance: no square root is needed.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_vote.h>
+
+#include <math.h>
+
+static float median(float* v, uint8_t n) {
+	for(uint8_t i = 1; i < n; i++) {
+		float x = v[i];
+		uint8_t j = i;
+
+		for(; j > 0 && v[j - 1] > x; j--) {
+			v[j] = v[j - 1];
+		}
+		v[j] = x;
+	}
+
+	return n & 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+static uint8_t select_voters(uint8_t sensors, const bool* valid, uint8_t* voters, bool* rejected) {
+	uint8_t n = 0;
+
+	for(uint8_t i = 0; i < sensors; i++) {
+		rejected[i] = false;
+
+		if(valid[i] && n < VOTE_MAX_SENSORS) {
+			voters[n++] = i;
+		}
+	}
+
+	return n;
+}
+
+static float component_median(const float* component, const uint8_t* voters, uint8_t n, float* sorted) {
+	for(uint8_t k = 0; k < n; k++) {
+		sorted[k] = component[voters[k]];
+	}
+
+	return median(sorted, n);
+}
+
+uint8_t sensor_vote(const float* values, uint8_t sensors, uint8_t axes, const bool* valid,
+		const float* tolerance, float* result, bool* rejected) {
+	uint8_t voters[VOTE_MAX_SENSORS];
+	float reading[VOTE_MAX_SENSORS], deviation[VOTE_MAX_SENSORS], sorted[VOTE_MAX_SENSORS];
+	uint8_t n = select_voters(sensors, valid, voters, rejected);
+
+	if(n == 0) {
+		return 0;
+	}
+
+	for(uint8_t axis = 0; axis < axes; axis++) {
+		for(uint8_t k = 0; k < n; k++) {
+			reading[k] = values[voters[k] * axes + axis];
+			sorted[k] = reading[k];
+		}
+
+		float center = median(sorted, n);
+
+		for(uint8_t k = 0; k < n; k++) {
+			deviation[k] = fabsf(reading[k] - center);
+			sorted[k] = deviation[k];
+		}
+
+		// half of the readings at least are within the median deviation, none is discarded with two
+		float bound = VOTE_OUTLIER_COEF * fmaxf(VOTE_MAD_TO_STD_DEV * median(sorted, n), tolerance[axis]);
+		float sum = 0;
+		uint8_t count = 0;
+
+		for(uint8_t k = 0; k < n; k++) {
+			if(deviation[k] <= bound) {
+				sum += reading[k];
+				count++;
+			} else {
+				rejected[voters[k]] = true;
+			}
+		}
+
+		result[axis] = sum / count;
+	}
+
+	return n;
+}
+
+uint8_t sensor_vote_vectors(const Vote_vectors* vectors, uint8_t kinds, uint8_t sensors, const bool* valid,
+		const float* tolerance, Vote_vector* result, bool* rejected) {
+	uint8_t voters[VOTE_MAX_SENSORS];
+	float distance[VOTE_MAX_SENSORS], sorted[VOTE_MAX_SENSORS];
+	float score[VOTE_MAX_SENSORS] = { 0 }; // worst squared distance over the squared bound, among the kinds
+	uint8_t n = select_voters(sensors, valid, voters, rejected);
+
+	if(n == 0) {
+		return 0;
+	}
+
+	for(uint8_t kind = 0; kind < kinds; kind++) {
+		const Vote_vectors* v = &vectors[kind];
+		float x = component_median(v->x, voters, n, sorted);
+		float y = component_median(v->y, voters, n, sorted);
+		float z = component_median(v->z, voters, n, sorted);
+
+		for(uint8_t k = 0; k < n; k++) {
+			float dx = v->x[voters[k]] - x;
+			float dy = v->y[voters[k]] - y;
+			float dz = v->z[voters[k]] - z;
+
+			distance[k] = dx * dx + dy * dy + dz * dz;
+			sorted[k] = distance[k];
+		}
+
+		float variance = VOTE_MEDIAN_DISTANCE_TO_STD_DEV * VOTE_MEDIAN_DISTANCE_TO_STD_DEV * median(sorted, n);
+		float bound = VOTE_VECTOR_OUTLIER_COEF * VOTE_VECTOR_OUTLIER_COEF * fmaxf(variance, tolerance[kind] * tolerance[kind]);
+
+		for(uint8_t k = 0; k < n; k++) {
+			score[k] = fmaxf(score[k], distance[k] / bound);
+		}
+	}
+
+	uint8_t count = 0, closest = 0;
+
+	for(uint8_t k = 0; k < n; k++) {
+		if(score[k] <= 1) {
+			count++;
+		} else {
+			rejected[voters[k]] = true;
+		}
+
+		if(score[k] < score[closest]) {
+			closest = k;
+		}
+	}
+
+	// a sensor off on one kind and another on the other may leave none
+	if(count == 0) {
+		rejected[voters[closest]] = false;
+		count = 1;
+	}
+
+	for(uint8_t kind = 0; kind < kinds; kind++) {
+		const Vote_vectors* v = &vectors[kind];
+		Vote_vector sum = { 0 };
+
+		for(uint8_t k = 0; k < n; k++) {
+			if(!rejected[voters[k]]) {
+				sum.x += v->x[voters[k]];
+				sum.y += v->y[voters[k]];
+				sum.z += v->z[voters[k]];
+			}
+		}
+
+		result[kind].x = sum.x / count;
+		result[kind].y = sum.y / count;
+		result[kind].z = sum.z / count;
+	}
+
+	return n;
+}
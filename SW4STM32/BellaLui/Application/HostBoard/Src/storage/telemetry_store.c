@@ -0,0 +1,352 @@
+/*
+ * telemetry_store.c
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <storage/telemetry_store.h>
+
+#include "cmsis_os.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <debug/led.h>
+#include <debug/console.h>
+
+#include <rocket_fs.h>
+#include <storage/flash_runtime.h>
+#include <misc/datastructs.h>
+
+#define RECORDS_PER_SEGMENT (TELEMETRY_STORE_SEGMENT_SIZE / TELEMETRY_STORE_RECORD_SIZE)
+#define TELEMETRY_STORE_PERIOD_MS 50
+
+typedef struct
+{
+	File* file;
+	uint32_t first_seq; // sequence number of the first record of the file
+	uint32_t records;
+} Segment;
+
+extern osMessageQId xBeeQueueHandle;
+
+// Ring of records filled by the telemetry senders and emptied by the store thread.
+static uint8_t staging[TELEMETRY_STORE_STAGING_RECORDS][TELEMETRY_STORE_RECORD_SIZE];
+static volatile uint32_t staging_head = 0;
+static volatile uint32_t staging_tail = 0;
+
+static Segment segments[TELEMETRY_STORE_SEGMENTS];
+static uint8_t active = 0; // segment being appended to
+
+static volatile bool request_pending = false;
+static volatile uint32_t request_first = 0;
+static volatile uint32_t request_last = 0;
+
+static bool backfill_active = false;
+static uint32_t backfill_next = 0; // next sequence number to resend
+static uint32_t backfill_last = 0;
+
+static TelemetryStore_stats stats = { 0 };
+
+
+static inline uint32_t record_seq(const uint8_t* record)
+{
+	return (record[0] << 24) | (record[1] << 16) | (record[2] << 8) | record[3];
+}
+
+/*
+ * Keeps a copy of a datagram which was handed to the xBee queue.
+ * Never blocks: if the store thread lags behind, the datagram is only counted as dropped.
+ */
+void telemetry_store(uint32_t seq, const uint8_t* datagram, uint16_t size)
+{
+	if (datagram == NULL || size > TELEMETRY_STORE_MAX_DATAGRAM_SIZE) {
+		return;
+	}
+
+	// the dummy frames of the xBee thread also end up here, hence the critical section
+	taskENTER_CRITICAL();
+
+	if (staging_head - staging_tail >= TELEMETRY_STORE_STAGING_RECORDS) {
+		stats.dropped++;
+		taskEXIT_CRITICAL();
+		return;
+	}
+
+	uint8_t* record = staging[staging_head % TELEMETRY_STORE_STAGING_RECORDS];
+	record[0] = (uint8_t) (seq >> 24);
+	record[1] = (uint8_t) (seq >> 16);
+	record[2] = (uint8_t) (seq >> 8);
+	record[3] = (uint8_t) seq;
+	record[4] = (uint8_t) size;
+	memcpy(record + 5, datagram, size);
+	memset(record + 5 + size, 0, TELEMETRY_STORE_MAX_DATAGRAM_SIZE - size);
+	staging_head++;
+
+	taskEXIT_CRITICAL();
+}
+
+/*
+ * Asks for the datagrams with a sequence number in [first_seq, last_seq] to be sent again.
+ * Replaces the request being served, if any.
+ */
+void telemetry_store_request(uint32_t first_seq, uint32_t last_seq)
+{
+	request_first = first_seq;
+	request_last = last_seq;
+	request_pending = true;
+}
+
+TelemetryStore_stats telemetry_store_get_stats()
+{
+	return stats;
+}
+
+/*
+ * Starts a new file in the given slot of the ring, deleting the one it replaces.
+ */
+static bool open_segment(FileSystem* fs, uint8_t index)
+{
+	char name[16];
+	sprintf(name, "TLM%d", index);
+
+	if (segments[index].file) {
+		rocket_fs_delfile(fs, segments[index].file);
+	}
+
+	segments[index].file = rocket_fs_newfile(fs, name, RAW);
+	segments[index].first_seq = 0;
+	segments[index].records = 0;
+
+	return segments[index].file != NULL;
+}
+
+static void flush_staging(FileSystem* fs)
+{
+	uint32_t head = staging_head;
+
+	if (head == staging_tail) {
+		return;
+	}
+
+	if (!segments[active].file && !open_segment(fs, active)) {
+		staging_tail = head; // nowhere to write, the records are lost
+		return;
+	}
+
+	Stream stream;
+	rocket_fs_stream(&stream, fs, segments[active].file, APPEND);
+
+	while (staging_tail != head) {
+		uint8_t* record = staging[staging_tail % TELEMETRY_STORE_STAGING_RECORDS];
+
+		if (segments[active].records >= RECORDS_PER_SEGMENT) {
+			stream.close();
+			active = (active + 1) % TELEMETRY_STORE_SEGMENTS;
+
+			if (!open_segment(fs, active)) {
+				staging_tail = head;
+				return;
+			}
+
+			rocket_fs_stream(&stream, fs, segments[active].file, APPEND);
+		}
+
+		if (segments[active].records == 0) {
+			segments[active].first_seq = record_seq(record);
+		}
+
+		stream.write(record, TELEMETRY_STORE_RECORD_SIZE);
+		segments[active].records++;
+		stats.stored++;
+
+		staging_tail++;
+	}
+
+	stream.close();
+}
+
+/*
+ * Queues a stored datagram for the xBee thread.
+ *
+ * The xBee thread frees m->ptr once the datagram is sent, so the message itself lives
+ * right after the datagram bytes, in the same allocation, and is released with it.
+ */
+static bool resend_record(const uint8_t* record)
+{
+	uint16_t size = record[4];
+	uint16_t offset = (size + 3) & ~3; // keep the message word-aligned
+
+	uint8_t* block = pvPortMalloc(offset + sizeof(Telemetry_Message));
+
+	if (!block) {
+		return false;
+	}
+
+	memcpy(block, record + 5, size);
+
+	Telemetry_Message* m = (Telemetry_Message*) (block + offset);
+	m->ptr = block;
+	m->size = size;
+
+	if (osMessagePut(xBeeQueueHandle, (uint32_t) m, 0) != osOK) {
+		vPortFree(block);
+		return false;
+	}
+
+	return true;
+}
+
+static inline bool backfill_interrupted()
+{
+	return request_pending || staging_head - staging_tail >= TELEMETRY_STORE_STAGING_RECORDS / 2;
+}
+
+/*
+ * Resends stored datagrams while the xBee queue has spare room.
+ *
+ * Streams cannot seek, so every call reads the segment holding backfill_next from its
+ * beginning. The call returns early, to be resumed later, when the staging buffer needs
+ * flushing or a new request comes in.
+ */
+static void backfill(FileSystem* fs)
+{
+	uint8_t record[TELEMETRY_STORE_RECORD_SIZE];
+	int8_t start = -1;
+
+	// newest segment starting at or before backfill_next, oldest one if everything older was overwritten
+	for (uint8_t k = 1; k <= TELEMETRY_STORE_SEGMENTS; k++) {
+		Segment* segment = &segments[(active + k) % TELEMETRY_STORE_SEGMENTS];
+
+		if (segment->records == 0) {
+			continue;
+		}
+
+		if (start < 0 || segment->first_seq <= backfill_next) {
+			start = k;
+		}
+	}
+
+	if (start < 0) {
+		backfill_active = false;
+		return;
+	}
+
+	for (uint8_t k = start; k <= TELEMETRY_STORE_SEGMENTS; k++) {
+		Segment* segment = &segments[(active + k) % TELEMETRY_STORE_SEGMENTS];
+
+		if (segment->records == 0) {
+			continue;
+		}
+
+		Stream stream;
+		rocket_fs_stream(&stream, fs, segment->file, OVERWRITE);
+
+		if (!stream.read) {
+			continue;
+		}
+
+		for (uint32_t i = 0; i < segment->records; i++) {
+			if (backfill_interrupted()) {
+				stream.close();
+				return;
+			}
+
+			if (stream.read(record, TELEMETRY_STORE_RECORD_SIZE) < TELEMETRY_STORE_RECORD_SIZE) {
+				break;
+			}
+
+			uint32_t seq = record_seq(record);
+
+			if (seq < backfill_next) {
+				continue;
+			}
+
+			if (seq > backfill_last) {
+				stream.close();
+				backfill_active = false;
+				return;
+			}
+
+			// only use what the live telemetry leaves free
+			while (osMessageAvailableSpace(xBeeQueueHandle) <= TELEMETRY_STORE_QUEUE_RESERVE) {
+				osDelay(TELEMETRY_STORE_PERIOD_MS / 10);
+
+				if (backfill_interrupted()) {
+					stream.close();
+					return;
+				}
+			}
+
+			if (!resend_record(record)) {
+				stream.close();
+				return; // out of memory, try again later
+			}
+
+			backfill_next = seq + 1;
+			stats.resent++;
+		}
+
+		stream.close();
+	}
+
+	backfill_active = false; // everything stored so far was sent
+}
+
+void TK_telemetry_store(void const* args)
+{
+	(void) args;
+
+	uint32_t led_identifier = led_register_TK();
+
+	FileSystem* fs = get_flash_fs();
+
+	if (!fs) {
+		while (true) {
+			led_set_TK_rgb(led_identifier, 50, 0, 0);
+			osDelay(1000);
+		}
+	}
+
+	/*
+	 * Sequence numbers restart at every reset: the records of a previous run would be
+	 * mistaken for the current ones.
+	 */
+	for (uint8_t i = 0; i < TELEMETRY_STORE_SEGMENTS; i++) {
+		char name[16];
+		sprintf(name, "TLM%d", i);
+
+		File* file = rocket_fs_getfile(fs, name);
+
+		if (file) {
+			rocket_fs_delfile(fs, file);
+		}
+
+		segments[i].file = NULL;
+		segments[i].records = 0;
+	}
+
+	while (true) {
+		flush_staging(fs);
+
+		if (request_pending) {
+			taskENTER_CRITICAL();
+			backfill_next = request_first;
+			backfill_last = request_last;
+			request_pending = false;
+			taskEXIT_CRITICAL();
+
+			backfill_active = backfill_next <= backfill_last;
+			rocket_log("Backfill of datagrams %ld to %ld requested\n", backfill_next, backfill_last);
+		}
+
+		if (backfill_active) {
+			led_set_TK_rgb(led_identifier, 0, 0, 50);
+			backfill(fs);
+		} else {
+			led_set_TK_rgb(led_identifier, 0, 50, 50);
+			osDelay(TELEMETRY_STORE_PERIOD_MS);
+		}
+	}
+}
@@ -11,12 +11,10 @@
 #include <telemetry/simpleCRC.h>
 #include <telemetry/telemetry_protocol.h>
 
-#define MALLOC_SIZE 64 // same malloc size for all datagrams, otherwise it fragments the memory
-
 DatagramBuilder::DatagramBuilder (uint16_t datagramPayloadSize, uint8_t datagramType, uint32_t datagramSequenceNumber) :
     datagramSize (datagramPayloadSize + TOTAL_DATAGRAM_OVERHEAD)
 {
-	datagramPtr = pvPortMalloc (MALLOC_SIZE);
+	datagramPtr = pvPortMalloc (DATAGRAM_MALLOC_SIZE);
 	if (datagramPtr != NULL)
     {
 		currentIdx = 0;
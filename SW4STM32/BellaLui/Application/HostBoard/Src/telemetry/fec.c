@@ -0,0 +1,171 @@
+/*
+ * fec.c
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <telemetry/fec.h>
+#include <telemetry/simpleCRC.h>
+#include <telemetry/telemetry_protocol.h>
+
+#include <string.h>
+
+#define GF_PRIMITIVE_POLY 0x11d
+#define FEC_COLUMNS (FEC_MAX_DATAGRAM_SIZE + 1) // length byte + datagram bytes
+
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+static uint8_t generator[FEC_PARITY_COUNT + 1]; // generator[k] is the coefficient of x^k
+
+static uint8_t parity[FEC_PARITY_COUNT][FEC_COLUMNS];
+static uint16_t member_crc[FEC_GROUP_SIZE];
+static uint8_t members = 0;
+static uint8_t columns = 0; // number of columns used by the current group
+static uint8_t group = 0;
+
+static FEC_stats stats = { 0 };
+
+
+static inline uint8_t gf_mul(uint8_t a, uint8_t b)
+{
+	if (a == 0 || b == 0) {
+		return 0;
+	}
+	return gf_exp[gf_log[a] + gf_log[b]];
+}
+
+/*
+ * Builds the GF(2^8) tables and the generator polynomial g(x) = (x - a^0)(x - a^1)...(x - a^(R-1)).
+ */
+void fec_init()
+{
+	uint16_t x = 1;
+	for (uint16_t i = 0; i < 255; i++) {
+		gf_exp[i] = (uint8_t) x;
+		gf_log[x] = (uint8_t) i;
+		x <<= 1;
+		if (x & 0x100) {
+			x ^= GF_PRIMITIVE_POLY;
+		}
+	}
+	for (uint16_t i = 255; i < 512; i++) {
+		gf_exp[i] = gf_exp[i - 255];
+	}
+
+	memset(generator, 0, sizeof(generator));
+	generator[0] = 1;
+	for (uint8_t i = 0; i < FEC_PARITY_COUNT; i++) { // multiply by (x + a^i)
+		for (int8_t k = i + 1; k > 0; k--) {
+			generator[k] = generator[k - 1] ^ gf_mul(generator[k], gf_exp[i]);
+		}
+		generator[0] = gf_mul(generator[0], gf_exp[i]);
+	}
+
+	memset(parity, 0, sizeof(parity));
+	members = 0;
+	columns = 0;
+}
+
+/*
+ * One step of the systematic RS encoder (division by g(x)) for a single column.
+ */
+static inline void fec_encode_symbol(uint8_t column, uint8_t symbol)
+{
+	uint8_t feedback = symbol ^ parity[0][column];
+
+	for (uint8_t j = 0; j < FEC_PARITY_COUNT - 1; j++) {
+		parity[j][column] = parity[j + 1][column] ^ gf_mul(feedback, generator[FEC_PARITY_COUNT - 1 - j]);
+	}
+	parity[FEC_PARITY_COUNT - 1][column] = gf_mul(feedback, generator[0]);
+}
+
+/*
+ * Adds a datagram to the current group.
+ *
+ * Returns the number of parity datagrams which must be sent (through fec_build_parity)
+ * before the next datagram is added: FEC_PARITY_COUNT once the group is complete, 0 otherwise.
+ */
+uint8_t fec_add_datagram(const uint8_t* datagram, uint16_t size)
+{
+	if (size > FEC_MAX_DATAGRAM_SIZE) {
+		return 0;
+	}
+
+	uint16_t crc = CRC_16_GENERATOR_POLY.initialValue;
+	for (uint16_t i = 0; i < size; i++) {
+		crc = CalculateRemainderFromTable(datagram[i], crc);
+	}
+	member_crc[members] = FinalizeCRC(crc);
+
+	if (size + 1 > columns) {
+		columns = size + 1;
+	}
+
+	// Columns beyond the longest datagram seen so far only contain zeros and keep a zero parity.
+	fec_encode_symbol(0, (uint8_t) size);
+	for (uint8_t c = 1; c < columns; c++) {
+		fec_encode_symbol(c, c <= size ? datagram[c - 1] : 0);
+	}
+
+	stats.data_bytes += size;
+
+	if (++members < FEC_GROUP_SIZE) {
+		return 0;
+	}
+
+	stats.groups++;
+	return FEC_PARITY_COUNT;
+}
+
+/*
+ * Writes the parity datagram of the given index into the buffer (at least FEC_PARITY_MAX_SIZE bytes).
+ * Building the last parity datagram starts a new group.
+ *
+ * Returns the size of the datagram.
+ */
+uint16_t fec_build_parity(uint8_t index, uint8_t* buffer)
+{
+	uint16_t pos = 0;
+
+	buffer[pos++] = FEC_PACKET;
+	buffer[pos++] = 'E';
+	buffer[pos++] = 'P';
+	buffer[pos++] = 'F';
+	buffer[pos++] = 'L';
+	buffer[pos++] = group;
+	buffer[pos++] = index;
+	buffer[pos++] = members;
+	buffer[pos++] = columns;
+
+	for (uint8_t i = 0; i < members; i++) {
+		buffer[pos++] = (uint8_t) (member_crc[i] >> 8);
+		buffer[pos++] = (uint8_t) member_crc[i];
+	}
+
+	memcpy(buffer + pos, parity[index], columns);
+	pos += columns;
+
+	uint16_t crc = CRC_16_GENERATOR_POLY.initialValue;
+	for (uint16_t i = 0; i < pos; i++) {
+		crc = CalculateRemainderFromTable(buffer[i], crc);
+	}
+	crc = FinalizeCRC(crc);
+	buffer[pos++] = (uint8_t) (crc >> 8);
+	buffer[pos++] = (uint8_t) crc;
+
+	stats.parity_bytes += pos;
+
+	if (index == FEC_PARITY_COUNT - 1) {
+		memset(parity, 0, sizeof(parity));
+		members = 0;
+		columns = 0;
+		group++;
+	}
+
+	return pos;
+}
+
+FEC_stats fec_get_stats()
+{
+	return stats;
+}
@@ -10,15 +10,22 @@
 #include <misc/Common.h>
 #include <misc/data_handling.h>
 #include <misc/datagram_builder.h>
+#include <misc/datagram_layout.h>
 #include "cmsis_os.h"
 
 #include <stdbool.h>
 #include <telemetry/simpleCRC.h>
 #include <telemetry/telemetry_protocol.h>
+#include <telemetry/uplink.h>
+#include <threads.h>
+#include <debug/console.h>
+#include <debug/profiler.h>
+#include <string.h>
 
 extern "C" {
 	#include <CAN_communication.h>
 	#include <storage/sd_card.h>
+	#include <storage/telemetry_store.h>
 }
 
 
@@ -29,22 +36,25 @@ extern "C" {
 #define AB_TIMEMIN 100
 //#define TELE_RAW_TIMEMIN 100
 
-volatile static uint32_t Packet_Number = 0;
-
 // for import in C code
 extern "C" bool telemetry_sendGPSData(GPS_data data);
 extern "C" bool telemetry_sendIMUData(IMU_data data);
 extern "C" bool telemetry_sendBaroData(BARO_data data);
-extern "C" bool telemetry_sendWarningPacketData(bool id, float value, uint8_t av_state);
+extern "C" bool telemetry_sendWarningPacketData(uint8_t id, float value, uint8_t av_state);
 extern "C" bool telemetry_sendMotorPressureData(uint32_t pressure);
 extern "C" bool telemetry_sendABData();
 
 extern "C" bool telemetry_receiveOrderPacket(uint8_t* RX_Order_Packet);
 extern "C" bool telemetry_receiveIgnitionPacket(uint8_t* RX_Ignition_Packet);
+extern "C" bool telemetry_receiveBackfillRequestPacket(uint8_t* RX_Backfill_Packet);
+#ifdef DATAGRAM_BENCHMARK
+extern "C" void telemetry_benchmarkDatagrams();
+#endif
 
 extern osMessageQId xBeeQueueHandle;
 
 uint32_t telemetrySeqNumber = 0;
+uint32_t ackSeqNumber = 0; // the ACKs are not stored, they are numbered apart from the telemetry
 uint8_t current_state = STATE_IDLE;
 
 IMU_data  imu  = {{0,0,0},{0,0,0}, 0};
@@ -63,89 +73,115 @@ Telemetry_Message m6;
 //Telemetry_Message m7;
 //Telemetry_Message m8;
 
+UplinkWindow uplink_window = { false, 0, 0 };
+
 Telemetry_Message event;
 
+// Layouts of the downlink datagrams: time stamp, packet number, then the payload fields
+typedef DatagramLayout<TELEMETRY_PACKET, SENSOR_DATAGRAM_PAYLOAD_SIZE, uint32_t, uint32_t,
+		float32_t, float32_t, float32_t, float32_t, float32_t, float32_t,
+		float32_t, float32_t, float32_t, float32_t> SensorDatagram;
+typedef DatagramLayout<AIRBRAKES_PACKET, AB_DATAGRAM_PAYLOAD_SIZE, uint32_t, uint32_t, float32_t> AirbrakesDatagram;
+typedef DatagramLayout<GPS_PACKET, GPS_DATAGRAM_PAYLOAD_SIZE, uint32_t, uint32_t,
+		uint8_t, float32_t, float32_t, float32_t, int32_t> GPSDatagram;
+typedef DatagramLayout<MOTOR_PACKET, MOTORPRESSURE_DATAGRAM_PAYLOAD_SIZE, uint32_t, uint32_t, float32_t> MotorPressureDatagram;
+typedef DatagramLayout<STATUS_PACKET, WARNING_DATAGRAM_PAYLOAD_SIZE, uint32_t, uint32_t,
+		uint8_t, float32_t, uint8_t> WarningDatagram;
+typedef DatagramLayout<ACK_PACKET, ACK_DATAGRAM_PAYLOAD_SIZE, uint32_t, uint32_t,
+		uint8_t, uint32_t, uint8_t> AckDatagram;
+
+// the message of an ACK lives in the allocation of its datagram, word-aligned after it
+static constexpr uint16_t ACK_MESSAGE_OFFSET = (AckDatagram::SIZE + 3) & ~3;
+static_assert(ACK_MESSAGE_OFFSET + sizeof(Telemetry_Message) <= DATAGRAM_MALLOC_SIZE, "no room left for the message of an ACK");
+
 //the createXXXDatagram-Methods create the datagrams as described in the Schema (should be correct)
 
 Telemetry_Message createTelemetryDatagram (IMU_data* imu_data, BARO_data* baro_data, uint32_t time_stamp, uint32_t telemetrySeqNumber)
 {
-
-	//here, the Datagram is created
-	DatagramBuilder builder = DatagramBuilder (SENSOR_DATAGRAM_PAYLOAD_SIZE, TELEMETRY_PACKET, telemetrySeqNumber);
-
-	// ## Beginning of datagram Payload ##
-	// time stamp
-	builder.write32<uint32_t> (time_stamp);
-	builder.write32<uint32_t> (Packet_Number++);
-	builder.write32<float32_t> (imu_data->acceleration.x);
-	builder.write32<float32_t> (imu_data->acceleration.y);
-	builder.write32<float32_t> (imu_data->acceleration.z);
-
-	builder.write32<float32_t> (imu_data->eulerAngles.x);
-	builder.write32<float32_t> (imu_data->eulerAngles.y);
-	builder.write32<float32_t> (imu_data->eulerAngles.z);
-
-	builder.write32<float32_t> (baro_data->temperature);
-	builder.write32<float32_t> (baro_data->pressure);
-
-	builder.write32<float32_t> (can_getSpeed()); // pitot_press
-	//baro_data->temperature = 20;
-
-
-	builder.write32<float32_t> (can_getAltitude());
-
-	return builder.finalizeDatagram ();
+	return SensorDatagram::build (
+			time_stamp,
+			telemetrySeqNumber, // packet number, see telemetry_store.h
+			imu_data->acceleration.x,
+			imu_data->acceleration.y,
+			imu_data->acceleration.z,
+			imu_data->eulerAngles.x,
+			imu_data->eulerAngles.y,
+			imu_data->eulerAngles.z,
+			baro_data->temperature,
+			baro_data->pressure,
+			can_getSpeed(), // pitot_press
+			can_getAltitude());
 }
 
 Telemetry_Message createAirbrakesDatagram (uint32_t time_stamp, uint32_t telemetrySeqNumber)
 {
-	DatagramBuilder builder = DatagramBuilder (AB_DATAGRAM_PAYLOAD_SIZE, AIRBRAKES_PACKET, telemetrySeqNumber++);
-	builder.write32<uint32_t> (time_stamp);
-	builder.write32<uint32_t> (Packet_Number++);
-	builder.write32<float32_t> (can_getABangle()); // AB_angle
-
-	return builder.finalizeDatagram ();
+	return AirbrakesDatagram::build (time_stamp, telemetrySeqNumber, can_getABangle()); // AB_angle
 }
 
 //same structure for the other createXXXDatagrams
 Telemetry_Message createGPSDatagram (uint32_t seqNumber, GPS_data gpsData)
 {
-	DatagramBuilder builder = DatagramBuilder (GPS_DATAGRAM_PAYLOAD_SIZE, GPS_PACKET, seqNumber++);
-
-	builder.write32<uint32_t> (HAL_GetTick ());
-	builder.write32<uint32_t> (Packet_Number++);
-	builder.write8 (gpsData.sats);
-	builder.write32<float32_t> (gpsData.hdop);
-	builder.write32<float32_t> (gpsData.lat);
-	builder.write32<float32_t> (gpsData.lon);
-	builder.write32<int32_t> (gpsData.altitude);
-
-	return builder.finalizeDatagram ();
+	return GPSDatagram::build (HAL_GetTick (), seqNumber, gpsData.sats, gpsData.hdop, gpsData.lat, gpsData.lon, gpsData.altitude);
 }
 
 Telemetry_Message createMotorPressurePacketDatagram(uint32_t time_stamp, float32_t pressure, uint32_t seqNumber)
 {
-	DatagramBuilder builder = DatagramBuilder (MOTORPRESSURE_DATAGRAM_PAYLOAD_SIZE, MOTOR_PACKET, seqNumber++);
-
-	builder.write32<uint32_t> (time_stamp);
-	builder.write32<uint32_t> (Packet_Number++);
-	builder.write32<float32_t> (pressure);
-
-	return builder.finalizeDatagram();
+	return MotorPressureDatagram::build (time_stamp, seqNumber, pressure);
 }
 //new
 Telemetry_Message createWarningPacketDatagram(uint32_t time_stamp, uint8_t id, float value, uint8_t av_state, uint32_t seqNumber)
 {
-	DatagramBuilder builder = DatagramBuilder (WARNING_DATAGRAM_PAYLOAD_SIZE, STATUS_PACKET, seqNumber++);
+	return WarningDatagram::build (time_stamp, seqNumber, id, value, av_state); // av_state: flight status
+}
 
-	builder.write32<uint32_t> (time_stamp);
-	builder.write32<uint32_t> (Packet_Number++);
-	builder.write8 (id);
-	builder.write32 (value);
-	builder.write8(av_state); // flight status
+Telemetry_Message createAckDatagram(uint32_t time_stamp, uint8_t datagram_id, uint32_t acked_seq, uint8_t verdict, uint32_t seqNumber)
+{
+	return AckDatagram::build (time_stamp, seqNumber, datagram_id, acked_seq, verdict); // acked_seq: packet number of the acknowledged order
+}
 
-	return builder.finalizeDatagram();
+#ifdef DATAGRAM_BENCHMARK
+/*
+ * Builds the same sensor datagram with DatagramBuilder and with SensorDatagram,
+ * checks that both are identical and logs the average cycle count of each.
+ */
+void telemetry_benchmarkDatagrams()
+{
+	const uint32_t runs = 1000;
+	uint32_t builder_cycles = 0;
+	uint32_t layout_cycles = 0;
+	uint32_t mismatches = 0;
+
+	profiler_init();
+
+	for (uint32_t i = 0; i < runs; i++) {
+		float32_t value = (float32_t) i;
+
+		uint32_t start = profiler_cycles();
+		DatagramBuilder builder = DatagramBuilder (SENSOR_DATAGRAM_PAYLOAD_SIZE, TELEMETRY_PACKET, i);
+		builder.write32<uint32_t> (i);
+		builder.write32<uint32_t> (i);
+		for (uint8_t k = 0; k < 10; k++) {
+			builder.write32<float32_t> (value);
+		}
+		Telemetry_Message reference = builder.finalizeDatagram ();
+		builder_cycles += profiler_cycles() - start;
+
+		start = profiler_cycles();
+		Telemetry_Message m = SensorDatagram::build (i, i, value, value, value, value, value, value, value, value, value, value);
+		layout_cycles += profiler_cycles() - start;
+
+		if (reference.ptr && m.ptr && memcmp (reference.ptr, m.ptr, SensorDatagram::CRC_OFFSET + 2) != 0) {
+			mismatches++;
+		}
+
+		vPortFree (reference.ptr);
+		vPortFree (m.ptr);
+	}
+
+	rocket_log("DatagramBuilder: %ld cycles, DatagramLayout: %ld cycles, %ld mismatches\n",
+			builder_cycles / runs, layout_cycles / runs, mismatches);
 }
+#endif
 
 /*
 Telemetry_Message createOrderPacketDatagram(uint32_t time_stamp)
@@ -188,16 +224,44 @@ Telemetry_Message createTelemetryRawDatagram(uint32_t time_stamp, float32_t eule
 //createIgnitionDatagram
 
 
+/*
+ * The senders run in the xBee thread, for the dummy frames, as well as in the CAN reader.
+ */
+static uint32_t telemetry_nextSeqNumber()
+{
+	taskENTER_CRITICAL();
+	uint32_t seqNumber = telemetrySeqNumber++;
+	taskEXIT_CRITICAL();
+	return seqNumber;
+}
+
+/*
+ * Hands a datagram to the xBee thread and keeps a copy of it for a later backfill request.
+ */
+static void telemetry_enqueue(Telemetry_Message* m, uint32_t seqNumber)
+{
+	if (m->ptr == NULL) {
+		return; // out of memory
+	}
+
+#ifdef TELEMETRY_STORE
+	telemetry_store(seqNumber, (uint8_t*) m->ptr, m->size);
+#endif
+
+	if (osMessagePut (xBeeQueueHandle, (uint32_t) m, 10) != osOK) {
+		vPortFree(m->ptr); // free the datagram if we couldn't queue it
+	}
+}
+
 bool telemetry_sendGPSData(GPS_data data) {
 	static uint32_t last_update = 0;
 	uint32_t now = HAL_GetTick();
 	bool handled = false;
 
 	if (now - last_update > GPS_TIMEMIN) {
-		m1 = createGPSDatagram (telemetrySeqNumber++, data);
-		if (osMessagePut (xBeeQueueHandle, (uint32_t) &m1, 10) != osOK) {
-			vPortFree(m1.ptr); // free the datagram if we couldn't queue it
-		}
+		uint32_t seqNumber = telemetry_nextSeqNumber();
+		m1 = createGPSDatagram (seqNumber, data);
+		telemetry_enqueue (&m1, seqNumber);
 		last_update = now;
 		handled = true;
 	}
@@ -211,10 +275,9 @@ bool telemetry_sendIMUData(IMU_data data) {
 	imu = data;
 
 	if (now - last_sensor_update > TELE_TIMEMIN) {
-		m2 = createTelemetryDatagram (&imu, &baro, now, telemetrySeqNumber++);
-		if (osMessagePut (xBeeQueueHandle, (uint32_t) &m2, 10) != osOK) {
-			vPortFree(m2.ptr); // free the datagram if we couldn't queue it
-		}
+		uint32_t seqNumber = telemetry_nextSeqNumber();
+		m2 = createTelemetryDatagram (&imu, &baro, now, seqNumber);
+		telemetry_enqueue (&m2, seqNumber);
 		last_sensor_update = now;
 		handled = true;
 	}
@@ -228,10 +291,9 @@ bool telemetry_sendBaroData(BARO_data data) {
 	baro = data;
 
 	if (now - last_sensor_update > TELE_TIMEMIN) {
-		m3 = createTelemetryDatagram (&imu, &baro, now, telemetrySeqNumber++);
-		if (osMessagePut (xBeeQueueHandle, (uint32_t) &m3, 10) != osOK) {
-			vPortFree(m3.ptr); // free the datagram if we couldn't queue it
-		}
+		uint32_t seqNumber = telemetry_nextSeqNumber();
+		m3 = createTelemetryDatagram (&imu, &baro, now, seqNumber);
+		telemetry_enqueue (&m3, seqNumber);
 		last_sensor_update = now;
 		handled = true;
 	}
@@ -244,26 +306,24 @@ bool telemetry_sendMotorPressureData(uint32_t pressure)
 	bool handled = false;
 
 	if (now - last_motor_update > MOTOR_TIMEMIN) {
-		m4 = createMotorPressurePacketDatagram (pressure, now, telemetrySeqNumber++);
-		if (osMessagePut (xBeeQueueHandle, (uint32_t) &m4, 10) != osOK) {
-			vPortFree(m4.ptr); // free the datagram if we couldn't queue it
-		}
+		uint32_t seqNumber = telemetry_nextSeqNumber();
+		m4 = createMotorPressurePacketDatagram (pressure, now, seqNumber);
+		telemetry_enqueue (&m4, seqNumber);
 		last_motor_update = now;
 		handled = true;
 	}
 	return handled;
 }
 
-bool telemetry_sendWarningPacketData(bool id, float value, uint8_t av_state)
+bool telemetry_sendWarningPacketData(uint8_t id, float value, uint8_t av_state)
 {
 	uint32_t now = HAL_GetTick();
 	bool handled = false;
 
 	if (now - last_warning_update > WARNING_TIMEMIN) {
-		m5 = createWarningPacketDatagram (now, id, value, av_state, telemetrySeqNumber++);
-		if (osMessagePut (xBeeQueueHandle, (uint32_t) &m5, 10) != osOK) {
-			vPortFree(m5.ptr); // free the datagram if we couldn't queue it
-		}
+		uint32_t seqNumber = telemetry_nextSeqNumber();
+		m5 = createWarningPacketDatagram (now, id, value, av_state, seqNumber);
+		telemetry_enqueue (&m5, seqNumber);
 		last_warning_update = now;
 		handled = true;
 	}
@@ -275,10 +335,9 @@ bool telemetry_sendABData() {
 	bool handled = false;
 
 	if (now - last_airbrakes_update > AB_TIMEMIN) {
-		m6 = createAirbrakesDatagram (now, telemetrySeqNumber++);
-		if (osMessagePut (xBeeQueueHandle, (uint32_t) &m6, 10) != osOK) {
-			vPortFree(m6.ptr); // free the datagram if we couldn't queue it
-		}
+		uint32_t seqNumber = telemetry_nextSeqNumber();
+		m6 = createAirbrakesDatagram (now, seqNumber);
+		telemetry_enqueue (&m6, seqNumber);
 		last_airbrakes_update = now;
 		handled = true;
 	}
@@ -287,10 +346,46 @@ bool telemetry_sendABData() {
 
 // Received Packet Handling
 
+/*
+ * Acknowledges an uplink command.
+ *
+ * ACKs are not rate limited and are put in front of the xBee queue so that they
+ * are not delayed by the bulk telemetry. The ground station retransmits the command
+ * until it receives the ACK, hence a lost ACK only costs a retransmission.
+ *
+ * Any number of ACKs may wait in the queue: the xBee thread frees m->ptr once the
+ * datagram is sent, and the message goes with it, as for the backfilled datagrams.
+ * Only the reception thread sends ACKs, and it does not need the telemetry lock.
+ */
+static void telemetry_sendAck(uint8_t datagram_id, uint32_t acked_seq, enum UplinkVerdict verdict)
+{
+	Telemetry_Message ack = createAckDatagram (HAL_GetTick(), datagram_id, acked_seq, verdict, ackSeqNumber++);
+
+	if (ack.ptr == NULL) {
+		return; // out of memory
+	}
+
+	Telemetry_Message* m = (Telemetry_Message*) ((uint8_t*) ack.ptr + ACK_MESSAGE_OFFSET);
+	*m = ack;
+
+	uint32_t item = (uint32_t) m;
+	if (xQueueSendToFront (xBeeQueueHandle, &item, 10) != pdPASS) {
+		vPortFree(ack.ptr); // free the datagram if we couldn't queue it
+	}
+}
+
 bool telemetry_receiveOrderPacket(uint8_t* RX_Order_Packet) {
 
 	uint32_t ts = RX_Order_Packet[3] | (RX_Order_Packet[2] << 8) | (RX_Order_Packet[1] << 16) | (RX_Order_Packet[0] << 24);
 	uint32_t packet_nbr = RX_Order_Packet[7] | (RX_Order_Packet[6] << 8) | (RX_Order_Packet[5] << 16) | (RX_Order_Packet[4] << 24);
+
+	enum UplinkVerdict verdict = uplink_accept(&uplink_window, packet_nbr);
+	telemetry_sendAck(ORDER_PACKET, packet_nbr, verdict);
+
+	if (verdict != UPLINK_NEW) {
+		return false; // retransmission of an order which was already executed
+	}
+
 	switch (RX_Order_Packet[8])
 	{
 		case STATE_OPEN_FILL_VALVE:
@@ -303,7 +398,7 @@ bool telemetry_receiveOrderPacket(uint8_t* RX_Order_Packet) {
 		current_state = STATE_OPEN_PURGE_VALVE;
 			break;
 		}
-		case STATE_OPEN_FILL_VALVE:
+		case STATE_OPEN_PURGE_VALVE:
 		{
 			current_state = STATE_OPEN_PURGE_VALVE;
 			break;
@@ -315,16 +410,43 @@ bool telemetry_receiveOrderPacket(uint8_t* RX_Order_Packet) {
 		}
 	}
 	can_setFrame((int32_t) current_state, DATA_ID_ORDER, ts);
-	return 0;
+	return true;
 }
 
 bool telemetry_receiveIgnitionPacket(uint8_t* RX_Ignition_Packet) {
 	uint32_t ts = RX_Ignition_Packet[3] | (RX_Ignition_Packet[2] << 8) | (RX_Ignition_Packet[1] << 16) | (RX_Ignition_Packet[0] << 24);
 	uint32_t packet_nbr = RX_Ignition_Packet[7] | (RX_Ignition_Packet[6] << 8) | (RX_Ignition_Packet[5] << 16) | (RX_Ignition_Packet[4] << 24);
+
+	enum UplinkVerdict verdict = uplink_accept(&uplink_window, packet_nbr);
+	telemetry_sendAck(IGNITION_PACKET, packet_nbr, verdict);
+
+	if (verdict != UPLINK_NEW) {
+		return false; // never fire the ignition twice for the same command
+	}
+
 	if( RX_Ignition_Packet[8] == 0x22) {
 		can_setFrame((int32_t) 0x22, DATA_ID_IGNITION, ts);
+		return true;
 	}
-	return 0;
+	return false;
 }
 
+bool telemetry_receiveBackfillRequestPacket(uint8_t* RX_Backfill_Packet) {
+	uint32_t packet_nbr = RX_Backfill_Packet[7] | (RX_Backfill_Packet[6] << 8) | (RX_Backfill_Packet[5] << 16) | (RX_Backfill_Packet[4] << 24);
+	uint32_t first_seq = RX_Backfill_Packet[11] | (RX_Backfill_Packet[10] << 8) | (RX_Backfill_Packet[9] << 16) | (RX_Backfill_Packet[8] << 24);
+	uint32_t last_seq = RX_Backfill_Packet[15] | (RX_Backfill_Packet[14] << 8) | (RX_Backfill_Packet[13] << 16) | (RX_Backfill_Packet[12] << 24);
 
+	enum UplinkVerdict verdict = uplink_accept(&uplink_window, packet_nbr);
+	telemetry_sendAck(BACKFILL_REQUEST_PACKET, packet_nbr, verdict);
+
+	if (verdict != UPLINK_NEW) {
+		return false; // do not restart a backfill which is already running
+	}
+
+#ifdef TELEMETRY_STORE
+	telemetry_store_request(first_seq, last_seq);
+	return true;
+#else
+	return false;
+#endif
+}
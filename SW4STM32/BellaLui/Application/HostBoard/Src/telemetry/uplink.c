@@ -0,0 +1,62 @@
+/*
+ * uplink.c
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <telemetry/uplink.h>
+
+
+void uplink_reset(UplinkWindow* window)
+{
+	window->initialised = false;
+	window->last_seq = 0;
+	window->history = 0;
+}
+
+/*
+ * Classifies a received sequence number and records it in the window.
+ *
+ * Sequence numbers are compared modulo 2^32 so that the window keeps working
+ * if the ground station counter ever wraps around. A jump back by more than
+ * UPLINK_SESSION_GAP starts a new session, as if the window had just been reset.
+ */
+enum UplinkVerdict uplink_accept(UplinkWindow* window, uint32_t seq)
+{
+	int32_t delta = (int32_t) (seq - window->last_seq);
+
+	if (!window->initialised || delta < -UPLINK_SESSION_GAP) {
+		window->initialised = true;
+		window->last_seq = seq;
+		window->history = 0;
+		return UPLINK_NEW;
+	}
+
+	if (delta > 0) { // newer than anything seen so far, slide the window forward
+		if (delta > UPLINK_WINDOW_SIZE) {
+			window->history = 0;
+		} else {
+			// the previous last_seq becomes bit (delta - 1)
+			window->history = ((window->history << 1) | 1) << (delta - 1);
+		}
+		window->last_seq = seq;
+		return UPLINK_NEW;
+	}
+
+	if (delta == 0) {
+		return UPLINK_DUPLICATE;
+	}
+
+	uint32_t age = (uint32_t) (-delta) - 1;
+
+	if (age >= UPLINK_WINDOW_SIZE) {
+		return UPLINK_STALE;
+	}
+
+	if (window->history & (1UL << age)) {
+		return UPLINK_DUPLICATE;
+	}
+
+	window->history |= (1UL << age); // late but never seen: accept out of order
+	return UPLINK_NEW;
+}
@@ -13,6 +13,8 @@
 #include <telemetry/telemetry_handling.h>
 #include <telemetry/telemetry_protocol.h>
 #include <telemetry/xbee.h>
+#include <telemetry/fec.h>
+#include <threads.h>
 
 osMessageQId xBeeQueueHandle;
 osSemaphoreId xBeeTxBufferSemHandle;
@@ -70,6 +72,10 @@ uint8_t payloadBuffer[XBEE_PAYLOAD_MAX_SIZE];
 uint8_t txDmaBuffer[2 * XBEE_PAYLOAD_MAX_SIZE + XBEE_CHECKSUM_SIZE + XBEE_FRAME_BEGINNING_SIZE];
 uint16_t currentXbeeTxBufPos = 0;
 
+#ifdef XBEE_FEC
+uint8_t fecParityBuffer[FEC_PARITY_MAX_SIZE];
+#endif
+
 int led_xbee_id;
 
 void xbee_freertos_init(UART_HandleTypeDef *huart) {
@@ -112,6 +118,10 @@ void TK_xBeeTransmit (const void* args)
   led_set_TK_rgb(led_xbee_id, 100, 50, 0);
 
   initXbee ();
+
+#ifdef DATAGRAM_BENCHMARK
+  telemetry_benchmarkDatagrams ();
+#endif
   uint32_t packetStartTime = HAL_GetTick();
 
 
@@ -152,7 +162,23 @@ void receiveData ()
 	// do nothing
 }
 
+static void bufferDatagram (uint8_t* txData, uint16_t txDataSize);
+
 void sendData (uint8_t* txData, uint16_t txDataSize)
+{
+  bufferDatagram (txData, txDataSize);
+
+#ifdef XBEE_FEC
+  // parity datagrams follow the last datagram of each FEC group
+  uint8_t parityCount = fec_add_datagram (txData, txDataSize);
+  for (uint8_t i = 0; i < parityCount; i++)
+    {
+      bufferDatagram (fecParityBuffer, fec_build_parity (i, fecParityBuffer));
+    }
+#endif
+}
+
+static void bufferDatagram (uint8_t* txData, uint16_t txDataSize)
 {
   if (txDataSize >= XBEE_PAYLOAD_MAX_SIZE)
     {
@@ -254,6 +280,10 @@ void initXbee ()
       checksum += XBEE_FRAME_OPTIONS[i];
     }
   XBEE_FRAME_OPTIONS_CRC = checksum;
+
+#ifdef XBEE_FEC
+  fec_init ();
+#endif
 }
 
 inline uint8_t escapedCharacter (uint8_t byte)
@@ -323,6 +353,12 @@ void processReceivedPacket ()
 			telemetry_receiveIgnitionPacket(RX_Ignition_Packet);
 			break;
 		}
+		case BACKFILL_REQUEST_PACKET:
+		{
+			uint8_t* RX_Backfill_Packet = rxPacketBuffer + START_DELIMITER_SIZE + MSB_SIZE + LSB_SIZE + XBEE_RECEIVED_OPTIONS_SIZE + DATAGRAM_ID_SIZE + PREFIXE_EPFL_SIZE;
+			telemetry_receiveBackfillRequestPacket(RX_Backfill_Packet);
+			break;
+		}
 		default :
 		{
 			break;
@@ -386,6 +422,11 @@ void set_packet_size(uint8_t datagram_id) {
 			packetSize = IGNITION_PACKET_SIZE;
 	    	break;
 		}
+		case BACKFILL_REQUEST_PACKET:
+		{
+			packetSize = BACKFILL_REQUEST_PACKET_SIZE;
+			break;
+		}
 		case TELEMETRY_PACKET:
 		{
 			packetSize = TELEMETRY_PACKET_SIZE;
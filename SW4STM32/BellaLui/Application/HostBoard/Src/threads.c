@@ -14,6 +14,9 @@
 #include <debug/led.h>
 #include <storage/flash_logging.h>
 #include <storage/heavy_io.h>
+#include <storage/telemetry_store.h>
+#include <sensors/sensor_i2c.h>
+#include <sensors/sensor_sampling.h>
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -25,10 +28,12 @@ osThreadId loggingHandle;
 osThreadId sdWriteHandle;
 osThreadId task_ABHandle;
 osThreadId sensorBoardHandle;
+osThreadId sensorProbeHandle;
 osThreadId task_LEDHandle;
 osThreadId task_GPSHandle;
 osThreadId telemetryTransmissionHandle;
 osThreadId telemetryReceptionHandle;
+osThreadId telemetryStoreHandle;
 osThreadId canReaderHandle;
 osThreadId kalmanHandle;
 osThreadId rocketfsmHandle;
@@ -38,6 +43,12 @@ osThreadId state_estimatorHandle;
 void create_semaphores() {
 	init_heavy_scheduler();
 	init_logging();
+
+	#ifdef SENSOR
+	  sensor_i2c_init();
+	  sampling_init();
+	  sensor_board_init();
+	#endif
 }
 
 void create_threads() {
@@ -79,6 +90,8 @@ void create_threads() {
 	#ifdef SENSOR
 	  osThreadDef(sensor_board, TK_sensor_board, osPriorityNormal, 0, 1024);
 	  sensorBoardHandle = osThreadCreate(osThread(sensor_board), NULL);
+	  osThreadDef(sensor_probe, TK_sensor_probe, osPriorityBelowNormal, 0, 512);
+	  sensorProbeHandle = osThreadCreate(osThread(sensor_probe), NULL);
 	#endif
 
 	#ifdef XBEE
@@ -89,6 +102,11 @@ void create_threads() {
 	  telemetryReceptionHandle = osThreadCreate(osThread(xBeeReception), NULL);
 	#endif
 
+	#ifdef TELEMETRY_STORE
+	  osThreadDef(telemetryStore, TK_telemetry_store, osPriorityNormal, 0, 512);
+	  telemetryStoreHandle = osThreadCreate(osThread(telemetryStore), NULL);
+	#endif
+
 	#ifdef KALMAN
 	  osThreadDef(kalman, TK_kalman, osPriorityNormal, 0, 1024);
 	  kalmanHandle = osThreadCreate(osThread(kalman), NULL);
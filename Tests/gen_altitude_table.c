@@ -0,0 +1,49 @@
+/*
+ * gen_altitude_table.c
+ *
+ * Writes altitude_table.c, for the table bounds of sensor_board.h and the
+ * ADJUSTED_SEA_LEVEL_PRESSURE of rocket_constants.h, to the standard output:
+ *
+ *   make altitude_table
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_board.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#define VALUES_PER_LINE 6
+
+int main() {
+	double sea_level = ADJUSTED_SEA_LEVEL_PRESSURE;
+
+	printf("/*\n"
+			" * altitude_table.c\n"
+			" *\n"
+			" * Altitude [m] of the pressures from ALTITUDE_TABLE_MIN_HPA to ALTITUDE_TABLE_MAX_HPA by\n"
+			" * steps of ALTITUDE_TABLE_STEP_HPA, with 44330 * (1 - (p / %g)^0.1903) in double\n"
+			" * precision. Generated by Tests/gen_altitude_table.c: run make altitude_table in\n"
+			" * Tests/ whenever ADJUSTED_SEA_LEVEL_PRESSURE changes.\n"
+			" *\n"
+			" *  Created on: 17 Oct 2026\n"
+			" */\n"
+			"\n"
+			"#include <sensors/sensor_board.h>\n"
+			"\n"
+			"const float altitude_table[ALTITUDE_TABLE_SIZE] = {\n", sea_level);
+
+	for(int i = 0; i < ALTITUDE_TABLE_SIZE; i++) {
+		double pressure = ALTITUDE_TABLE_MIN_HPA + i * ALTITUDE_TABLE_STEP_HPA;
+		double altitude = 44330 * (1 - pow(pressure / sea_level, 0.1903));
+		bool last = i == ALTITUDE_TABLE_SIZE - 1;
+
+		printf("%s%.4ff%s", i % VALUES_PER_LINE ? " " : "\t", altitude,
+				last ? "\n" : (i % VALUES_PER_LINE == VALUES_PER_LINE - 1 ? ",\n" : ","));
+	}
+
+	printf("};\n");
+	return 0;
+}
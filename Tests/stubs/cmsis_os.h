@@ -0,0 +1,41 @@
+/*
+ * cmsis_os.h
+ *
+ * Host stand-in for the few RTOS calls of the modules under test, implemented in
+ * os_host.c with POSIX threads. Queue items are pointers cast to uint32_t as on the
+ * board, hence the blocks of pvPortMalloc are taken in the low 4 GB of memory.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef CMSIS_OS_H_
+#define CMSIS_OS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef enum {
+	osOK = 0,
+	osErrorResource = 0x81
+} osStatus;
+
+typedef struct os_queue* osMessageQId;
+
+osStatus osMessagePut(osMessageQId queue, uint32_t info, uint32_t millisec);
+uint32_t osMessageAvailableSpace(osMessageQId queue);
+osStatus osDelay(uint32_t millisec);
+
+void* pvPortMalloc(size_t size);
+void vPortFree(void* block);
+
+void os_enter_critical(void);
+void os_exit_critical(void);
+
+#define taskENTER_CRITICAL() os_enter_critical()
+#define taskEXIT_CRITICAL() os_exit_critical()
+
+// host side of the tests
+osMessageQId os_queue_create(uint32_t length);
+int os_queue_get(osMessageQId queue, uint32_t* info); // 0 when empty
+
+#endif /* CMSIS_OS_H_ */
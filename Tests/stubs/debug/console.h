@@ -0,0 +1,15 @@
+/*
+ * console.h
+ *
+ * Host stand-in: the logs of the modules under test are dropped, their formats are the
+ * ones of the 32-bit board.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef DEBUG_CONSOLE_H_
+#define DEBUG_CONSOLE_H_
+
+#define rocket_log(...) ((void) 0)
+
+#endif /* DEBUG_CONSOLE_H_ */
@@ -0,0 +1,25 @@
+/*
+ * led.h
+ *
+ * Host stand-in: the threads under test have no LED to show their state.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef DEBUG_LED_H_
+#define DEBUG_LED_H_
+
+#include <stdint.h>
+
+static inline uint32_t led_register_TK(void) {
+	return 0;
+}
+
+static inline void led_set_TK_rgb(uint32_t identifier, uint8_t r, uint8_t g, uint8_t b) {
+	(void) identifier;
+	(void) r;
+	(void) g;
+	(void) b;
+}
+
+#endif /* DEBUG_LED_H_ */
@@ -0,0 +1,120 @@
+/*
+ * os_host.c
+ *
+ * The RTOS calls of cmsis_os.h on a host: a single recursive mutex for the critical
+ * sections, queues of 32-bit items and a pool of fixed-size blocks mapped in the low
+ * 4 GB of memory (Linux x86-64). Time runs OS_HOST_TIME_SCALE times faster than on
+ * the board.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#define _GNU_SOURCE
+
+#include "cmsis_os.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#define OS_HOST_TIME_SCALE 50
+#define POOL_BLOCK_SIZE 128
+#define POOL_BLOCKS 4096
+
+struct os_queue {
+	uint32_t* items;
+	uint32_t length;
+	uint32_t head, tail;
+};
+
+static pthread_mutex_t critical = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
+
+static uint8_t* pool = NULL;
+static void* free_blocks[POOL_BLOCKS];
+static uint32_t free_count = 0;
+
+void os_enter_critical(void) {
+	pthread_mutex_lock(&critical);
+}
+
+void os_exit_critical(void) {
+	pthread_mutex_unlock(&critical);
+}
+
+osStatus osDelay(uint32_t millisec) {
+	usleep(millisec * 1000 / OS_HOST_TIME_SCALE);
+	return osOK;
+}
+
+void* pvPortMalloc(size_t size) {
+	void* block = NULL;
+
+	os_enter_critical();
+	if(pool == NULL) {
+		pool = mmap(NULL, POOL_BLOCK_SIZE * POOL_BLOCKS, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+		if(pool == MAP_FAILED) {
+			abort();
+		}
+		for(uint32_t i = 0; i < POOL_BLOCKS; i++) {
+			free_blocks[free_count++] = pool + (POOL_BLOCKS - 1 - i) * POOL_BLOCK_SIZE;
+		}
+	}
+	if(size <= POOL_BLOCK_SIZE && free_count > 0) {
+		block = free_blocks[--free_count];
+	}
+	os_exit_critical();
+
+	return block;
+}
+
+void vPortFree(void* block) {
+	if(block == NULL) {
+		return;
+	}
+	os_enter_critical();
+	free_blocks[free_count++] = block;
+	os_exit_critical();
+}
+
+osMessageQId os_queue_create(uint32_t length) {
+	osMessageQId queue = calloc(1, sizeof(struct os_queue));
+	queue->items = calloc(length, sizeof(uint32_t));
+	queue->length = length;
+	return queue;
+}
+
+osStatus osMessagePut(osMessageQId queue, uint32_t info, uint32_t millisec) {
+	(void) millisec; // never waits
+	osStatus status = osErrorResource;
+
+	os_enter_critical();
+	if(queue->head - queue->tail < queue->length) {
+		queue->items[queue->head++ % queue->length] = info;
+		status = osOK;
+	}
+	os_exit_critical();
+
+	return status;
+}
+
+uint32_t osMessageAvailableSpace(osMessageQId queue) {
+	os_enter_critical();
+	uint32_t space = queue->length - (queue->head - queue->tail);
+	os_exit_critical();
+	return space;
+}
+
+int os_queue_get(osMessageQId queue, uint32_t* info) {
+	int received = 0;
+
+	os_enter_critical();
+	if(queue->head != queue->tail) {
+		*info = queue->items[queue->tail++ % queue->length];
+		received = 1;
+	}
+	os_exit_critical();
+
+	return received;
+}
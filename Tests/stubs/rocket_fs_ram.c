@@ -0,0 +1,100 @@
+/*
+ * rocket_fs_ram.c
+ *
+ * The file calls of RocketFS on a host, with the files in RAM. A single stream is open
+ * at a time, as its calls take no handle.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <rocket_fs.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+static uint8_t* contents[NUM_FILES];
+static uint32_t capacity[NUM_FILES];
+
+static FileSystem* stream_fs;
+static uint32_t stream_index;
+static uint32_t stream_position;
+static bool stream_eof;
+
+static void stream_close() {
+	stream_fs = NULL;
+}
+
+static int32_t stream_read(uint8_t* buffer, uint32_t length) {
+	File* file = &stream_fs->files[stream_index];
+	uint32_t left = file->length - stream_position;
+
+	if(length > left) {
+		length = left;
+	}
+	memcpy(buffer, contents[stream_index] + stream_position, length);
+	stream_position += length;
+	stream_eof = stream_position == file->length;
+
+	return length;
+}
+
+static void stream_write(uint8_t* buffer, uint32_t length) {
+	File* file = &stream_fs->files[stream_index];
+
+	if(stream_position + length > capacity[stream_index]) {
+		capacity[stream_index] = 2 * (stream_position + length);
+		contents[stream_index] = realloc(contents[stream_index], capacity[stream_index]);
+	}
+	memcpy(contents[stream_index] + stream_position, buffer, length);
+	stream_position += length;
+
+	if(stream_position > file->length) {
+		file->length = stream_position;
+	}
+}
+
+File* rocket_fs_newfile(FileSystem* fs, const char* name, FileType type) {
+	(void) type; // all the files are kept as they are written
+	for(uint32_t i = 0; i < NUM_FILES; i++) {
+		if(fs->files[i].filename[0] == '\0') {
+			memset(&fs->files[i], 0, sizeof(File));
+			strncpy(fs->files[i].filename, name, sizeof(fs->files[i].filename) - 1);
+			return &fs->files[i];
+		}
+	}
+	return NULL;
+}
+
+void rocket_fs_delfile(FileSystem* fs, File* file) {
+	uint32_t i = file - fs->files;
+
+	free(contents[i]);
+	contents[i] = NULL;
+	capacity[i] = 0;
+	memset(file, 0, sizeof(File));
+}
+
+File* rocket_fs_getfile(FileSystem* fs, const char* name) {
+	for(uint32_t i = 0; i < NUM_FILES; i++) {
+		if(fs->files[i].filename[0] != '\0' && strcmp(fs->files[i].filename, name) == 0) {
+			return &fs->files[i];
+		}
+	}
+	return NULL;
+}
+
+bool rocket_fs_stream(Stream* stream, FileSystem* fs, File* file, StreamMode mode) {
+	memset(stream, 0, sizeof(Stream));
+
+	stream_fs = fs;
+	stream_index = file - fs->files;
+	stream_position = mode == APPEND ? file->length : 0;
+	stream_eof = stream_position == file->length;
+
+	stream->eof = &stream_eof;
+	stream->close = stream_close;
+	stream->read = stream_read;
+	stream->write = stream_write;
+
+	return true;
+}
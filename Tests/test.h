@@ -0,0 +1,35 @@
+/*
+ * test.h
+ *
+ * Checks of the host tests: a failed check is reported and counted, and the test goes
+ * on with the next one. main returns TEST_RESULT.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+#include <math.h>
+
+static int test_failures = 0;
+
+#define CHECK(condition) do { \
+	if(!(condition)) { \
+		fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+		test_failures++; \
+	} \
+} while(0)
+
+#define CHECK_NEAR(value, expected, tolerance) do { \
+	double value_ = (value), expected_ = (expected); \
+	if(!(fabs(value_ - expected_) <= (tolerance))) { \
+		fprintf(stderr, "%s:%d: %s = %g, expected %g within %g\n", __FILE__, __LINE__, #value, value_, expected_, (double) (tolerance)); \
+		test_failures++; \
+	} \
+} while(0)
+
+#define TEST_RESULT (test_failures ? (fprintf(stderr, "%d failed checks\n", test_failures), 1) : (printf("ok\n"), 0))
+
+#endif /* TEST_H_ */
@@ -0,0 +1,91 @@
+/*
+ * test_altitude_table.c
+ *
+ * altitudeFromPressure of sensor_board.h, by linear interpolation in altitude_table.c,
+ * against the barometric formula in double precision every 0.001 hPa of the table: at
+ * most 0.12 m apart, 0.03 m above 700 hPa where the curve is flatter. The time per call
+ * of the table and of the powf of altitudeFromPressureReference is reported.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_board.h>
+
+#include <time.h>
+
+#include "test.h"
+
+#define STEPS_PER_HPA 1000
+#define SAMPLES ((ALTITUDE_TABLE_MAX_HPA - ALTITUDE_TABLE_MIN_HPA) * STEPS_PER_HPA)
+#define RUNS 5
+
+static float pressures[SAMPLES];
+static volatile float sink;
+
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// the best time per call of a few runs
+static double time_per_call(float (*altitude)(float)) {
+	double best = 1e9;
+
+	for(int r = 0; r < RUNS; r++) {
+		double start = now();
+		for(int i = 0; i < SAMPLES; i++) {
+			sink = altitude(pressures[i]);
+		}
+		double seconds = now() - start;
+		best = seconds < best ? seconds : best;
+	}
+	return best / SAMPLES;
+}
+
+static float table(float pressure) {
+	return altitudeFromPressure(pressure);
+}
+
+static float reference(float pressure) {
+	return altitudeFromPressureReference(pressure);
+}
+
+static void test_error() {
+	double error = 0, high_error = 0;
+
+	for(int i = 0; i < SAMPLES; i++) {
+		pressures[i] = (float) (ALTITUDE_TABLE_MIN_HPA + (double) i / STEPS_PER_HPA);
+
+		double exact = 44330 * (1 - pow(pressures[i] / (double) ADJUSTED_SEA_LEVEL_PRESSURE, 0.1903));
+		double difference = fabs(altitudeFromPressure(pressures[i]) - exact);
+
+		error = fmax(error, difference);
+		if(pressures[i] > 700) {
+			high_error = fmax(high_error, difference);
+		}
+	}
+
+	CHECK(error <= 0.12);
+	CHECK(high_error <= 0.03);
+	printf("largest error: %.3f m, %.3f m above 700 hPa\n", error, high_error);
+}
+
+static void test_bounds() {
+	// the ends of the table and beyond, where the formula takes over
+	CHECK_NEAR(altitudeFromPressure(ALTITUDE_TABLE_MIN_HPA), altitude_table[0], 1e-3f);
+	CHECK_NEAR(altitudeFromPressure(ALTITUDE_TABLE_MAX_HPA - 1e-3f), altitude_table[ALTITUDE_TABLE_SIZE - 1], 0.05f);
+	CHECK_NEAR(altitudeFromPressure(ALTITUDE_TABLE_MAX_HPA), altitudeFromPressureReference(ALTITUDE_TABLE_MAX_HPA), 1e-3f);
+	CHECK_NEAR(altitudeFromPressure(200), altitudeFromPressureReference(200), 1e-3f);
+	CHECK_NEAR(altitudeFromPressure(ADJUSTED_SEA_LEVEL_PRESSURE), 0, 0.03f);
+}
+
+int main() {
+	test_error();
+	test_bounds();
+
+	printf("altitudeFromPressure: %.1f ns with the table, %.1f ns with powf\n",
+			1e9 * time_per_call(table), 1e9 * time_per_call(reference));
+
+	return TEST_RESULT;
+}
@@ -0,0 +1,155 @@
+/*
+ * test_apogee_predictor.c
+ *
+ * apogee_predict against the same model integrated in double precision with RK4 at a
+ * step 100 times shorter, over the coast from burnout to apogee, for the openings of
+ * the drag table. apogee_opening must bring the predicted apogee within
+ * OPENING_TOLERANCE_M of ROCKET_CST_TARGET_APOGEE, and stay closed when the rocket falls
+ * short of it, fully open when it overshoots it anyway. The predictions per second and
+ * the worst case of steps per control period are reported.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <airbrakes/apogee_predictor.h>
+#include <misc/rocket_constants.h>
+
+#include <time.h>
+
+#include "test.h"
+
+#define AB_PERIOD_MS 50 // as in airbrakes.c
+#define MAX_OPENING_DEG 210 // as in controller_functions.c
+
+#define REFERENCE_STEP_S (APOGEE_STEP_S / 100)
+#define PREDICTION_TOLERANCE_M 0.1 // [m] from the reference
+#define OPENING_TOLERANCE_M 0.5 // [m] from the target, after the iterations of the solver
+
+// the coast, from burnout to the last seconds before apogee
+#define MIN_ALTITUDE 800 // [m]
+#define MAX_ALTITUDE 2800
+#define ALTITUDE_STEP 200
+#define MIN_SPEED 20 // [m/s]
+#define MAX_SPEED 340
+#define SPEED_STEP 20
+#define OPENING_SPEED_STEP 1 // finer, the speeds which the airbrakes can correct span a few tens of m/s
+
+#define RUNS 5
+
+// as in apogee_predictor.c, at the openings of its table
+#define GRAVITY 9.81
+#define DENSITY_SCALE_HEIGHT 8500.0
+#define DRAG_TABLE_STEP_DEG 50
+#define DRAG_TABLE_SIZE 5
+static const double drag_table[DRAG_TABLE_SIZE] = { 1.2821e-4, 1.4541e-4, 1.6868e-4, 1.9533e-4, 2.2270e-4 };
+
+static volatile float sink;
+
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static double acceleration(double k, double h, double v) {
+	return -GRAVITY - k * exp(-h / DENSITY_SCALE_HEIGHT) * v * v;
+}
+
+// RK4, the apogee within the last step found from the speed at its start and the deceleration there
+static double reference_apogee(double h, double v, double k) {
+	const double dt = REFERENCE_STEP_S;
+
+	for(;;) {
+		double a1 = acceleration(k, h, v);
+		double a2 = acceleration(k, h + 0.5 * dt * v, v + 0.5 * dt * a1);
+		double a3 = acceleration(k, h + 0.5 * dt * (v + 0.5 * dt * a1), v + 0.5 * dt * a2);
+		double a4 = acceleration(k, h + dt * (v + 0.5 * dt * a2), v + dt * a3);
+		double next_v = v + dt / 6 * (a1 + 2 * a2 + 2 * a3 + a4);
+
+		if(next_v <= 0) {
+			return h + v * v / (-2 * a1);
+		}
+
+		h += dt / 6 * (6 * v + dt * (a1 + a2 + a3));
+		v = next_v;
+	}
+}
+
+static void test_prediction() {
+	double largest = 0;
+
+	for(int i = 0; i < DRAG_TABLE_SIZE; i++) {
+		for(int h = MIN_ALTITUDE; h <= MAX_ALTITUDE; h += ALTITUDE_STEP) {
+			for(int v = MIN_SPEED; v <= MAX_SPEED; v += SPEED_STEP) {
+				double error = fabs(apogee_predict(h, v, i * DRAG_TABLE_STEP_DEG) - reference_apogee(h, v, drag_table[i]));
+
+				CHECK(error < PREDICTION_TOLERANCE_M);
+				largest = error > largest ? error : largest;
+			}
+		}
+	}
+
+	printf("largest error of the prediction: %.3f m\n", largest);
+}
+
+static void test_opening() {
+	int solved = 0, closed = 0, open = 0;
+	double largest = 0;
+
+	for(int h = MIN_ALTITUDE; h <= MAX_ALTITUDE; h += ALTITUDE_STEP) {
+		for(int v = MIN_SPEED; v <= MAX_SPEED; v += OPENING_SPEED_STEP) {
+			float opening = apogee_opening(h, v, MAX_OPENING_DEG);
+
+			if(apogee_predict(h, v, 0) <= ROCKET_CST_TARGET_APOGEE) {
+				CHECK(opening == 0);
+				closed++;
+			} else if(apogee_predict(h, v, MAX_OPENING_DEG) >= ROCKET_CST_TARGET_APOGEE) {
+				CHECK(opening == MAX_OPENING_DEG);
+				open++;
+			} else {
+				double error = fabs(apogee_predict(h, v, opening) - ROCKET_CST_TARGET_APOGEE);
+
+				CHECK(opening > 0 && opening < MAX_OPENING_DEG);
+				CHECK(error < OPENING_TOLERANCE_M);
+				largest = error > largest ? error : largest;
+				solved++;
+			}
+		}
+	}
+
+	// the grid must cover the three cases
+	CHECK(solved > 0 && closed > 0 && open > 0);
+
+	printf("apogee_opening: %d states solved, at most %.3f m from the target, %d closed, %d fully open\n", solved,
+			largest, closed, open);
+}
+
+// the best time per prediction of a few runs, from burnout
+static double time_per_prediction() {
+	double best = 1e9;
+	int count = 0;
+
+	for(int r = 0; r < RUNS; r++) {
+		double start = now();
+		count = 0;
+		for(int h = MIN_ALTITUDE; h <= MAX_ALTITUDE; h += ALTITUDE_STEP) {
+			for(int v = MIN_SPEED; v <= MAX_SPEED; v += SPEED_STEP) {
+				sink = apogee_predict(h, v, MAX_OPENING_DEG / 2);
+				count++;
+			}
+		}
+		double seconds = now() - start;
+		best = seconds < best ? seconds : best;
+	}
+	return best / count;
+}
+
+int main() {
+	test_prediction();
+	test_opening();
+
+	printf("apogee_predict: %.0f predictions per second, at most %d steps per control period of %d ms\n",
+			1 / time_per_prediction(), (2 + APOGEE_SOLVER_ITERATIONS) * APOGEE_MAX_STEPS, AB_PERIOD_MS);
+
+	return TEST_RESULT;
+}
@@ -0,0 +1,129 @@
+/*
+ * test_bme280.c
+ *
+ * Compensation of the BME280 as fetch_bme does it, pressure and temperature only from
+ * the 6 bytes of their registers, against the driver's parse and compensation of all
+ * three channels from the 8 bytes of the former read. The raw ADC values and the
+ * calibration are the worked example of the Bosch datasheet, recorded on a sensor:
+ * both paths must give its 25.08 degC and 100653.27 Pa, and the same result on a climb
+ * from there. The time per sample of both paths is reported.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/BME280/bme280.h>
+
+#include <time.h>
+
+#include "test.h"
+
+#define SAMPLES 4096
+#define RUNS 5
+#define ALL_BYTES 8 // pressure, temperature and humidity registers
+#define PRESS_TEMP_BYTES 6
+
+// the datasheet example
+#define ADC_P 415148
+#define ADC_T 519888
+#define ADC_H 30000
+#define EXPECTED_TEMPERATURE 2508 // [0.01 degC]
+#define EXPECTED_PRESSURE 10065327 // [0.01 Pa]
+
+static struct bme280_calib_data calib = {
+	.dig_T1 = 27504, .dig_T2 = 26435, .dig_T3 = -1000,
+	.dig_P1 = 36477, .dig_P2 = -10685, .dig_P3 = 3024, .dig_P4 = 2855, .dig_P5 = 140,
+	.dig_P6 = -7, .dig_P7 = 15500, .dig_P8 = -14600, .dig_P9 = 6000,
+	.dig_H1 = 75, .dig_H2 = 362, .dig_H3 = 0, .dig_H4 = 313, .dig_H5 = 50, .dig_H6 = 30
+};
+
+static uint8_t registers[SAMPLES][ALL_BYTES];
+static volatile uint32_t sink;
+
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// as in sensor_board.c
+static inline uint32_t bme_adc(const uint8_t* msb) {
+	return ((uint32_t) msb[0] << 12) | ((uint32_t) msb[1] << 4) | (msb[2] >> 4);
+}
+
+static void set_registers(uint8_t* r, uint32_t pressure, uint32_t temperature, uint32_t humidity) {
+	r[0] = pressure >> 12;
+	r[1] = pressure >> 4;
+	r[2] = pressure << 4;
+	r[3] = temperature >> 12;
+	r[4] = temperature >> 4;
+	r[5] = temperature << 4;
+	r[6] = humidity >> 8;
+	r[7] = humidity;
+}
+
+static void compensate_all(const uint8_t* r, struct bme280_data* data) {
+	struct bme280_uncomp_data uncomp;
+
+	bme280_parse_sensor_data(r, &uncomp);
+	CHECK(bme280_compensate_data(BME280_ALL, &uncomp, data, &calib) == BME280_OK);
+}
+
+static void compensate_press_temp(const uint8_t* r, struct bme280_data* data) {
+	struct bme280_uncomp_data uncomp = { 0 };
+
+	uncomp.pressure = bme_adc(r);
+	uncomp.temperature = bme_adc(r + 3);
+	CHECK(bme280_compensate_data(BME280_PRESS | BME280_TEMP, &uncomp, data, &calib) == BME280_OK);
+}
+
+// the best time per sample of a few runs
+static double time_per_sample(void (*compensate)(const uint8_t*, struct bme280_data*)) {
+	struct bme280_data data;
+	double best = 1e9;
+
+	for(int r = 0; r < RUNS; r++) {
+		double start = now();
+		for(int i = 0; i < SAMPLES; i++) {
+			compensate(registers[i], &data);
+			sink += data.pressure;
+		}
+		double seconds = now() - start;
+		best = seconds < best ? seconds : best;
+	}
+	return best / SAMPLES;
+}
+
+static void test_datasheet_example() {
+	struct bme280_data all, press_temp;
+
+	set_registers(registers[0], ADC_P, ADC_T, ADC_H);
+	compensate_all(registers[0], &all);
+	compensate_press_temp(registers[0], &press_temp);
+
+	CHECK(all.temperature == EXPECTED_TEMPERATURE);
+	CHECK_NEAR(all.pressure, EXPECTED_PRESSURE, 1); // the datasheet rounds, the driver truncates
+	CHECK(press_temp.temperature == all.temperature && press_temp.pressure == all.pressure);
+}
+
+// the pressure falls as the rocket climbs, the temperature of the sensor wanders
+static void test_climb() {
+	for(int i = 0; i < SAMPLES; i++) {
+		struct bme280_data all, press_temp;
+
+		set_registers(registers[i], ADC_P + i * 20 + (i * 7919) % 37, ADC_T + (i % 64) * 3, ADC_H);
+		compensate_all(registers[i], &all);
+		compensate_press_temp(registers[i], &press_temp);
+
+		CHECK(press_temp.temperature == all.temperature && press_temp.pressure == all.pressure);
+	}
+}
+
+int main() {
+	test_datasheet_example();
+	test_climb();
+
+	printf("BME280: %.1f ns and %d bytes per sample for all the channels, %.1f ns and %d bytes for pressure and temperature\n",
+			1e9 * time_per_sample(compensate_all), ALL_BYTES, 1e9 * time_per_sample(compensate_press_temp), PRESS_TEMP_BYTES);
+
+	return TEST_RESULT;
+}
@@ -0,0 +1,169 @@
+/*
+ * test_ekf.cpp
+ *
+ * The Ekf template of kalman/ekf.h against ekf_step of tiny_ekf.c, on the 9-state model
+ * of the GPS estimator: the Jacobian of the attitude errors through mat_exp, a GPS
+ * position at 10 Hz and a baro altitude at 33 Hz. Every step starts both filters from
+ * the same state, and the sparse step, as well as the prediction followed by scalar
+ * updates, must give the estimate and the covariance of the dense step up to rounding.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <kalman/ekf.h>
+
+extern "C" {
+#include <kalman/tiny_ekf.h>
+#include <kalman/tinyekf_config.h>
+}
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+
+#define STEPS 100000
+#define DT 0.01f // [s]
+
+typedef Ekf<Nsta, Mobs> Filter;
+
+static ekf_t dense;
+static Filter sparse, scalar;
+static double dense_time = 0, sparse_time = 0, scalar_time = 0;
+
+static float noise(float amplitude) {
+	return amplitude * ((float) rand() / RAND_MAX * 2 - 1);
+}
+
+static double now() {
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// largest difference of the states in standard deviations, and of the covariances in correlations
+static void compare(const Filter& ekf, float* state, float* covariance) {
+	for(int i = 0; i < Nsta; i++) {
+		*state = fmaxf(*state, fabsf(ekf.x[i] - dense.x[i]) / sqrtf(dense.P[i][i]));
+		for(int j = 0; j < Nsta; j++) {
+			*covariance = fmaxf(*covariance, fabsf(ekf.P[i][j] - dense.P[i][j]) / sqrtf(dense.P[i][i] * dense.P[j][j]));
+		}
+	}
+}
+
+static void test_same_estimate() {
+	float state = 0, covariance = 0;
+	uint64_t macs = 0;
+
+	ekf_init(&dense, Nsta, Mobs);
+	for(int i = 0; i < Nsta; i++) {
+		sparse.P[i][i] = 1 + i * 0.1f;
+		sparse.Q[i][i] = 1e-3f + i * 1e-4f;
+	}
+	for(int i = 0; i < Mobs; i++) {
+		sparse.R[i][i] = i < 3 ? 9 : 1;
+	}
+
+	for(int k = 0; k < STEPS; k++) {
+		bool gps = k % 10 == 0, baro = k % 3 == 0;
+		float F[Nsta][Nsta] = { { 0 } };
+		float acceleration[3] = { noise(5), noise(5), noise(5) };
+		Vector<Mobs> z;
+
+		// attitude errors rotate the measured acceleration into the velocity
+		F[0][3] = F[1][4] = F[2][5] = DT;
+		F[3][7] = -acceleration[2] * DT;
+		F[3][8] = acceleration[1] * DT;
+		F[4][6] = acceleration[2] * DT;
+		F[4][8] = -acceleration[0] * DT;
+		F[5][6] = -acceleration[1] * DT;
+		F[5][7] = acceleration[0] * DT;
+		mat_exp(F, sparse.F.m, Nsta);
+
+		for(int i = 0; i < Nsta; i++) {
+			sparse.fx[i] = sparse.x[i] + DT * noise(3);
+		}
+		memset(sparse.H.m, 0, sizeof(sparse.H.m));
+		for(int i = 0; i < 3; i++) {
+			sparse.H[i][i] = gps;
+		}
+		sparse.H[3][2] = baro;
+		for(int i = 0; i < Mobs; i++) {
+			sparse.hx[i] = sparse.fx[i < 3 ? i : 2];
+			z[i] = sparse.hx[i] + noise(i < 3 ? 3 : 1);
+		}
+
+		scalar = sparse;
+		memcpy(dense.x, sparse.x.v, sizeof(dense.x));
+		memcpy(dense.P, sparse.P.m, sizeof(dense.P));
+		memcpy(dense.Q, sparse.Q.m, sizeof(dense.Q));
+		memcpy(dense.R, sparse.R.m, sizeof(dense.R));
+		memcpy(dense.F, sparse.F.m, sizeof(dense.F));
+		memcpy(dense.H, sparse.H.m, sizeof(dense.H));
+		memcpy(dense.fx, sparse.fx.v, sizeof(dense.fx));
+		memcpy(dense.hx, sparse.hx.v, sizeof(dense.hx));
+
+		double start = now();
+		CHECK(ekf_step(&dense, z.v) == 0);
+		double dense_end = now();
+		CHECK(sparse.step(z));
+		double sparse_end = now();
+		scalar.predict();
+		for(int r = 0; r < Mobs; r++) {
+			CHECK(scalar.update(r, z[r]));
+		}
+		double scalar_end = now();
+
+		dense_time += dense_end - start;
+		sparse_time += sparse_end - dense_end;
+		scalar_time += scalar_end - sparse_end;
+		macs += sparse.macs();
+
+		compare(sparse, &state, &covariance);
+		compare(scalar, &state, &covariance);
+	}
+
+	CHECK(state < 1e-3f);
+	CHECK(covariance < 1e-4f);
+	CHECK(macs / STEPS < Filter::DENSE_MACS);
+
+	printf("ekf_step %dx%d: %.0f ns dense, %.0f ns sparse, %.0f ns with scalar updates\n", Nsta, Mobs,
+			1e9 * dense_time / STEPS, 1e9 * sparse_time / STEPS, 1e9 * scalar_time / STEPS);
+	printf("%u multiply-accumulates dense, %u sparse on average\n", Filter::DENSE_MACS, (unsigned) (macs / STEPS));
+	printf("largest differences: %.1e standard deviation of a state, %.1e correlation of a covariance\n", state, covariance);
+}
+
+static void test_not_positive_definite() {
+	Filter ekf = sparse, before;
+	Vector<Mobs> z = { { 1, 2, 3, 4 } };
+
+	// a negative variance of the baro makes H P H^T + R not positive-definite
+	ekf.R[3][3] = -1e6f;
+	ekf.H[3][2] = 1;
+	for(int i = 0; i < Nsta; i++) {
+		ekf.fx[i] = ekf.x[i];
+	}
+	memcpy(dense.P, ekf.P.m, sizeof(dense.P));
+	memcpy(dense.R, ekf.R.m, sizeof(dense.R));
+	memcpy(dense.H, ekf.H.m, sizeof(dense.H));
+	CHECK(ekf_step(&dense, z.v) == 1);
+
+	before = ekf;
+	CHECK(!ekf.step(z));
+	CHECK(memcmp(ekf.x.v, before.x.v, sizeof(ekf.x.v)) == 0 && memcmp(ekf.P.m, before.P.m, sizeof(ekf.P.m)) == 0);
+
+	ekf.predict();
+	before = ekf;
+	CHECK(!ekf.update(3, z[3]));
+	CHECK(memcmp(ekf.x.v, before.x.v, sizeof(ekf.x.v)) == 0 && memcmp(ekf.P.m, before.P.m, sizeof(ekf.P.m)) == 0);
+}
+
+int main() {
+	srand(1);
+
+	test_same_estimate();
+	test_not_positive_definite();
+
+	return TEST_RESULT;
+}
@@ -0,0 +1,144 @@
+/*
+ * test_ekf_kernels.c
+ *
+ * ekf_step of tiny_ekf.c built twice, with the FMA dot products of ekf_kernels.h and
+ * with EKF_SCALAR_KERNELS, on a rocket model: positions, velocities and accelerations,
+ * the GPS position and the baro altitude observed. Both must give the same estimate up
+ * to rounding, far within its standard deviation, and the time per step of each, model
+ * included, is reported as the best of a few runs.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <kalman/tiny_ekf.h>
+#include <kalman/tinyekf_config.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "test.h"
+
+#define STEPS 100000
+#define RUNS 5
+#define DT 0.01f // [s]
+#define FLIGHT_STEPS 2000
+#define FLIGHTS (STEPS / FLIGHT_STEPS)
+
+// the same file built with EKF_SCALAR_KERNELS, see the Makefile
+void ekf_init_scalar(void* ekf, int n, int m);
+int ekf_step_scalar(void* ekf, float* z);
+
+static float measurements[STEPS][Mobs];
+
+static float noise(float amplitude) {
+	return amplitude * ((float) rand() / RAND_MAX * 2 - 1);
+}
+
+// a climb at 20 m/s^2 drifting sideways, seen by a GPS and a baro
+static void measure() {
+	for(int k = 0; k < STEPS; k++) {
+		float t = (k % FLIGHT_STEPS) * DT; // a new flight every 20 s, to keep the numbers in range
+		measurements[k][0] = 0.5f * 0.3f * t * t + noise(3);
+		measurements[k][1] = -0.5f * 0.2f * t * t + noise(3);
+		measurements[k][2] = 0.5f * 20 * t * t + noise(5);
+		measurements[k][3] = 0.5f * 20 * t * t + noise(1);
+	}
+}
+
+static void init(ekf_t* ekf, void (*init_function)(void*, int, int)) {
+	init_function(ekf, Nsta, Mobs);
+	memset(ekf->x, 0, sizeof(ekf->x));
+
+	for(int i = 0; i < Nsta; i++) {
+		ekf->P[i][i] = 10;
+		ekf->Q[i][i] = i < 6 ? 1e-4f : 1e-1f;
+		ekf->F[i][i] = 1;
+	}
+	for(int i = 0; i < 3; i++) {
+		ekf->F[i][i + 3] = DT;
+		ekf->F[i][i + 6] = 0.5f * DT * DT;
+		ekf->F[i + 3][i + 6] = DT;
+		ekf->H[i][i] = 1;
+		ekf->R[i][i] = 9;
+	}
+	ekf->H[3][2] = 1;
+	ekf->R[3][3] = 1;
+}
+
+// the linear model: fx = F x and hx = H fx
+static void model(ekf_t* ekf) {
+	for(int i = 0; i < Nsta; i++) {
+		ekf->fx[i] = 0;
+		for(int j = 0; j < Nsta; j++) {
+			ekf->fx[i] += ekf->F[i][j] * ekf->x[j];
+		}
+	}
+	for(int i = 0; i < Mobs; i++) {
+		ekf->hx[i] = 0;
+		for(int j = 0; j < Nsta; j++) {
+			ekf->hx[i] += ekf->H[i][j] * ekf->fx[j];
+		}
+	}
+}
+
+// returns the time per step, and keeps the filter at the end of each flight
+static double run(void (*init_function)(void*, int, int), int (*step)(void*, float*), ekf_t* flights) {
+	static ekf_t ekf;
+	struct timespec start, end;
+	double best = 1e9;
+
+	for(int r = 0; r < RUNS; r++) {
+		init(&ekf, init_function);
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for(int k = 0; k < STEPS; k++) {
+			model(&ekf);
+			CHECK(step(&ekf, measurements[k]) == 0);
+
+			if(k % FLIGHT_STEPS == FLIGHT_STEPS - 1) {
+				flights[k / FLIGHT_STEPS] = ekf;
+			}
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		double seconds = (end.tv_sec - start.tv_sec) + 1e-9 * (end.tv_nsec - start.tv_nsec);
+		best = seconds < best ? seconds : best;
+	}
+
+	return best / STEPS;
+}
+
+int main() {
+	static ekf_t fma_flights[FLIGHTS], scalar_flights[FLIGHTS];
+	float state_deviation = 0, covariance_deviation = 0;
+
+	srand(1);
+	measure();
+
+	double scalar_time = run(ekf_init_scalar, ekf_step_scalar, scalar_flights);
+	double fma_time = run(ekf_init, ekf_step, fma_flights);
+
+	// the states in standard deviations, the variances relative to the scalar kernels
+	for(int f = 0; f < FLIGHTS; f++) {
+		for(int i = 0; i < Nsta; i++) {
+			float x = scalar_flights[f].x[i], p = scalar_flights[f].P[i][i];
+			state_deviation = fmaxf(state_deviation, fabsf(fma_flights[f].x[i] - x) / sqrtf(p));
+			covariance_deviation = fmaxf(covariance_deviation, fabsf(fma_flights[f].P[i][i] - p) / p);
+		}
+	}
+	CHECK(state_deviation < 1e-2f);
+	CHECK(covariance_deviation < 1e-5f);
+
+#ifdef __FMA__
+	const char* kernels = "FMA";
+#else
+	const char* kernels = "scalar, no FMA on this host,";
+#endif
+	printf("ekf_step %dx%d: %.0f ns with the scalar kernels, %.0f ns with the %s kernels\n",
+			Nsta, Mobs, 1e9 * scalar_time, 1e9 * fma_time, kernels);
+	printf("largest differences: %.1e standard deviation of a state, %.1e of a variance\n",
+			state_deviation, covariance_deviation);
+
+	return TEST_RESULT;
+}
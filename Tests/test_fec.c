@@ -0,0 +1,306 @@
+/*
+ * test_fec.c
+ *
+ * The downlink FEC through a noisy channel: datagrams are dropped or corrupted at
+ * random, the ground station rebuilds the missing ones of each group from the
+ * parity datagrams, by erasure decoding of every RS(10, 8) column, and the rebuilt
+ * datagrams must be the ones that were sent. The ground station is assumed to place
+ * each datagram in its group by its packet number.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <telemetry/fec.h>
+#include <telemetry/simpleCRC.h>
+#include <telemetry/telemetry_protocol.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+#define K FEC_GROUP_SIZE
+#define R FEC_PARITY_COUNT
+#define GROUPS 20000
+
+enum Arrival { RECEIVED, LOST, CORRUPTED };
+
+typedef struct {
+	uint8_t data[K][FEC_MAX_DATAGRAM_SIZE];
+	uint16_t size[K];
+	uint8_t parity[R][FEC_PARITY_MAX_SIZE];
+	uint16_t parity_size[R];
+} Group;
+
+typedef struct {
+	uint32_t datagrams;
+	uint32_t received; // without the FEC
+	uint32_t recovered; // rebuilt from the parity
+} Result;
+
+static uint8_t gf_exp[512];
+static uint8_t gf_log[256];
+
+static void gf_init() {
+	uint16_t x = 1;
+	for(uint16_t i = 0; i < 255; i++) {
+		gf_exp[i] = gf_exp[i + 255] = (uint8_t) x;
+		gf_log[x] = (uint8_t) i;
+		x <<= 1;
+		if(x & 0x100) {
+			x ^= 0x11d;
+		}
+	}
+}
+
+static uint8_t gf_mul(uint8_t a, uint8_t b) {
+	return a && b ? gf_exp[gf_log[a] + gf_log[b]] : 0;
+}
+
+static uint8_t gf_div(uint8_t a, uint8_t b) {
+	return a ? gf_exp[gf_log[a] + 255 - gf_log[b]] : 0;
+}
+
+// a^(k * degree), the weight of a symbol in the syndrome k
+static uint8_t gf_weight(uint8_t k, uint8_t degree) {
+	return gf_exp[(k * degree) % 255];
+}
+
+static uint16_t crc16(const uint8_t* bytes, uint16_t size) {
+	uint16_t crc = CRC_16_GENERATOR_POLY.initialValue;
+	for(uint16_t i = 0; i < size; i++) {
+		crc = CalculateRemainderFromTable(bytes[i], crc);
+	}
+	return FinalizeCRC(crc);
+}
+
+// the datagrams of the board, of various sizes
+static void send_group(Group* group) {
+	for(uint8_t i = 0; i < K; i++) {
+		group->size[i] = rand() % 2 ? TELEMETRY_PACKET_SIZE : 20 + rand() % (FEC_MAX_DATAGRAM_SIZE - 19);
+		for(uint16_t b = 0; b < group->size[i]; b++) {
+			group->data[i][b] = rand();
+		}
+		CHECK(fec_add_datagram(group->data[i], group->size[i]) == (i == K - 1 ? R : 0));
+	}
+	for(uint8_t j = 0; j < R; j++) {
+		group->parity_size[j] = fec_build_parity(j, group->parity[j]);
+	}
+}
+
+static enum Arrival channel(uint8_t* datagram, uint16_t size, int loss_percent) {
+	int draw = rand() % 400;
+
+	if(draw < 4 * loss_percent) {
+		return LOST;
+	}
+	if(draw < 5 * loss_percent) { // a quarter as many corrupted as lost
+		datagram[rand() % size] ^= 1 + rand() % 255;
+		return CORRUPTED;
+	}
+	return RECEIVED;
+}
+
+/*
+ * Solves the erased symbols of every column from the R syndromes. Symbol i of a
+ * column, the datagrams then the parities, is the coefficient of x^(K + R - 1 - i).
+ */
+static bool decode(uint8_t symbols[][K + R], uint8_t columns, const bool* erased) {
+	uint8_t unknown[R], count = 0;
+
+	for(uint8_t i = 0; i < K + R; i++) {
+		if(erased[i]) {
+			if(count == R) {
+				return false;
+			}
+			unknown[count++] = i;
+		}
+	}
+
+	for(uint8_t c = 0; c < columns; c++) {
+		uint8_t matrix[R][R + 1];
+
+		for(uint8_t k = 0; k < count; k++) {
+			uint8_t syndrome = 0;
+			for(uint8_t i = 0; i < K + R; i++) {
+				if(!erased[i]) {
+					syndrome ^= gf_mul(symbols[c][i], gf_weight(k, K + R - 1 - i));
+				}
+			}
+			for(uint8_t u = 0; u < count; u++) {
+				matrix[k][u] = gf_weight(k, K + R - 1 - unknown[u]);
+			}
+			matrix[k][count] = syndrome;
+		}
+
+		// Gauss-Jordan: the Vandermonde matrix of distinct degrees is never singular
+		for(uint8_t p = 0; p < count; p++) {
+			uint8_t pivot = matrix[p][p];
+			for(uint8_t u = p; u <= count; u++) {
+				matrix[p][u] = gf_div(matrix[p][u], pivot);
+			}
+			for(uint8_t k = 0; k < count; k++) {
+				uint8_t factor = matrix[k][p];
+				if(k != p && factor) {
+					for(uint8_t u = p; u <= count; u++) {
+						matrix[k][u] ^= gf_mul(factor, matrix[p][u]);
+					}
+				}
+			}
+		}
+
+		for(uint8_t u = 0; u < count; u++) {
+			symbols[c][unknown[u]] = matrix[u][count];
+		}
+	}
+	return true;
+}
+
+/*
+ * Receives a group through the channel, rebuilds what it can and checks it against what
+ * was sent.
+ */
+static void receive_group(const Group* sent, int loss_percent, Result* result) {
+	Group group = *sent;
+	bool erased[K + R];
+	const uint8_t* header = NULL;
+
+	for(uint8_t j = 0; j < R; j++) {
+		uint16_t size = group.parity_size[j];
+		erased[K + j] = channel(group.parity[j], size, loss_percent) != RECEIVED
+				|| crc16(group.parity[j], size - 2) != ((group.parity[j][size - 2] << 8) | group.parity[j][size - 1]);
+		if(!erased[K + j]) {
+			header = group.parity[j];
+		}
+	}
+
+	bool missing = false;
+	for(uint8_t i = 0; i < K; i++) {
+		enum Arrival arrival = channel(group.data[i], group.size[i], loss_percent);
+
+		if(header) { // the CRC of every member is in the parity datagrams
+			erased[i] = arrival == LOST || crc16(group.data[i], group.size[i]) != ((header[FEC_HEADER_SIZE + 2 * i] << 8) | header[FEC_HEADER_SIZE + 2 * i + 1]);
+		} else { // else the ground station relies on the CRC of the datagram itself
+			erased[i] = arrival != RECEIVED;
+		}
+		CHECK(erased[i] == (arrival != RECEIVED));
+
+		result->datagrams++;
+		result->received += !erased[i];
+		missing |= erased[i];
+	}
+
+	if(!missing || !header) {
+		return;
+	}
+
+	uint8_t columns = header[8];
+	uint8_t symbols[FEC_MAX_DATAGRAM_SIZE + 1][K + R];
+
+	CHECK(header[0] == FEC_PACKET && header[7] == K && columns <= FEC_MAX_DATAGRAM_SIZE + 1);
+	for(uint8_t c = 0; c < columns; c++) {
+		for(uint8_t i = 0; i < K; i++) {
+			symbols[c][i] = c == 0 ? group.size[i] : (c <= group.size[i] ? group.data[i][c - 1] : 0);
+		}
+		for(uint8_t j = 0; j < R; j++) {
+			symbols[c][K + j] = group.parity[j][FEC_HEADER_SIZE + 2 * K + c];
+		}
+	}
+
+	if(!decode(symbols, columns, erased)) {
+		return;
+	}
+
+	for(uint8_t i = 0; i < K; i++) {
+		if(erased[i]) {
+			uint8_t size = symbols[0][i];
+			bool same = size == sent->size[i];
+
+			for(uint8_t c = 1; same && c <= size; c++) {
+				same = symbols[c][i] == sent->data[i][c - 1];
+			}
+			CHECK(same);
+			result->recovered += same;
+		}
+	}
+}
+
+static void test_known_erasures() {
+	Group sent;
+	const int8_t patterns[][R] = { { 3, 6 }, { 0, K }, { K - 1, K + 1 }, { 5, -1 }, { K, K + 1 } };
+
+	for(uint8_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+		Group group;
+		bool erased[K + R] = { false };
+		uint8_t symbols[FEC_MAX_DATAGRAM_SIZE + 1][K + R];
+
+		send_group(&sent);
+		group = sent;
+		for(uint8_t e = 0; e < R; e++) {
+			if(patterns[p][e] >= 0) {
+				erased[patterns[p][e]] = true;
+			}
+		}
+
+		uint8_t columns = group.parity[0][8];
+		for(uint8_t c = 0; c < columns; c++) {
+			for(uint8_t i = 0; i < K; i++) {
+				// the erased symbols are garbage, not zeros
+				symbols[c][i] = erased[i] ? 0xA5 : (c == 0 ? group.size[i] : (c <= group.size[i] ? group.data[i][c - 1] : 0));
+			}
+			for(uint8_t j = 0; j < R; j++) {
+				symbols[c][K + j] = erased[K + j] ? 0x5A : group.parity[j][FEC_HEADER_SIZE + 2 * K + c];
+			}
+		}
+
+		CHECK(decode(symbols, columns, erased));
+		for(uint8_t i = 0; i < K; i++) {
+			CHECK(symbols[0][i] == sent.size[i]);
+			for(uint8_t c = 1; c <= sent.size[i]; c++) {
+				CHECK(symbols[c][i] == sent.data[i][c - 1]);
+			}
+		}
+	}
+
+	// one more erasure than parities cannot be solved
+	bool erased[K + R] = { [1] = true, [2] = true, [K] = true };
+	uint8_t symbols[FEC_MAX_DATAGRAM_SIZE + 1][K + R] = { { 0 } };
+	CHECK(!decode(symbols, 1, erased));
+}
+
+static void test_noisy_channel(int loss_percent) {
+	Result result = { 0 };
+	FEC_stats before = fec_get_stats();
+
+	for(uint32_t g = 0; g < GROUPS; g++) {
+		Group sent;
+		send_group(&sent);
+		receive_group(&sent, loss_percent, &result);
+	}
+
+	FEC_stats stats = fec_get_stats();
+	float overhead = (float) (stats.parity_bytes - before.parity_bytes) / (stats.data_bytes - before.data_bytes);
+	float loss = 1 - (float) result.received / result.datagrams;
+	float residual = 1 - (float) (result.received + result.recovered) / result.datagrams;
+
+	printf("%2d %% lost, %2d %% corrupted: %5.2f %% of the datagrams missing, %5.2f %% with the FEC, %u recovered for %.0f %% more bytes\n",
+			loss_percent, loss_percent / 4, 100 * loss, 100 * residual, result.recovered, 100 * overhead);
+
+	CHECK(residual <= loss);
+}
+
+int main() {
+	srand(1);
+	gf_init();
+	fec_init();
+
+	test_known_erasures();
+	test_noisy_channel(0);
+	test_noisy_channel(1);
+	test_noisy_channel(5);
+	test_noisy_channel(10);
+	test_noisy_channel(20);
+
+	return TEST_RESULT;
+}
@@ -0,0 +1,277 @@
+/*
+ * test_sensor_vote.c
+ *
+ * Properties of the sensor votes, on readings drawn around a true value with the spread
+ * of healthy sensors.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <sensors/sensor_vote.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+#define AXES 2
+#define RUNS 10000
+
+static const float tolerance[AXES] = { 1.0f, 0.1f };
+static const float truth[AXES] = { 1000.0f, 20.0f };
+
+static float noise(float amplitude) {
+	return amplitude * ((float) rand() / RAND_MAX * 2 - 1);
+}
+
+static void healthy(float* values, uint8_t sensors) {
+	for(uint8_t i = 0; i < sensors; i++) {
+		for(uint8_t axis = 0; axis < AXES; axis++) {
+			values[i * AXES + axis] = truth[axis] + noise(tolerance[axis]);
+		}
+	}
+}
+
+static void all_valid(bool* valid, uint8_t sensors) {
+	for(uint8_t i = 0; i < sensors; i++) {
+		valid[i] = true;
+	}
+}
+
+static void test_agreeing_sensors_are_kept() {
+	float values[5 * AXES];
+	bool valid[5], rejected[5];
+	float result[AXES];
+	const float zero[AXES] = { 0, 0 };
+
+	for(uint8_t i = 0; i < 5; i++) {
+		values[i * AXES] = truth[0];
+		values[i * AXES + 1] = truth[1];
+	}
+	all_valid(valid, 5);
+
+	// no spread at all, and no tolerance to fall back on
+	CHECK(sensor_vote(values, 5, AXES, valid, zero, result, rejected) == 5);
+	for(uint8_t i = 0; i < 5; i++) {
+		CHECK(!rejected[i]);
+	}
+	CHECK(result[0] == truth[0] && result[1] == truth[1]);
+}
+
+static void test_single_outlier_is_rejected() {
+	for(int run = 0; run < RUNS; run++) {
+		uint8_t sensors = 3 + rand() % (VOTE_MAX_SENSORS - 2);
+		uint8_t outlier = rand() % sensors;
+		uint8_t axis = rand() % AXES;
+		float values[VOTE_MAX_SENSORS * AXES];
+		bool valid[VOTE_MAX_SENSORS], rejected[VOTE_MAX_SENSORS];
+		float result[AXES];
+
+		healthy(values, sensors);
+		values[outlier * AXES + axis] += (rand() % 2 ? 50 : -50) * tolerance[axis];
+		all_valid(valid, sensors);
+
+		CHECK(sensor_vote(values, sensors, AXES, valid, tolerance, result, rejected) == sensors);
+		for(uint8_t i = 0; i < sensors; i++) {
+			CHECK(rejected[i] == (i == outlier));
+		}
+		CHECK_NEAR(result[0], truth[0], tolerance[0]);
+		CHECK_NEAR(result[1], truth[1], tolerance[1]);
+	}
+}
+
+static void test_order_does_not_matter() {
+	for(int run = 0; run < RUNS; run++) {
+		uint8_t sensors = 1 + rand() % VOTE_MAX_SENSORS;
+		uint8_t order[VOTE_MAX_SENSORS];
+		float values[VOTE_MAX_SENSORS * AXES], shuffled[VOTE_MAX_SENSORS * AXES];
+		bool valid[VOTE_MAX_SENSORS], valid_shuffled[VOTE_MAX_SENSORS];
+		bool rejected[VOTE_MAX_SENSORS], rejected_shuffled[VOTE_MAX_SENSORS];
+		float result[AXES] = { 0, 0 }, result_shuffled[AXES] = { 0, 0 };
+
+		healthy(values, sensors);
+		if(sensors >= 3) {
+			values[(rand() % sensors) * AXES] += 100 * tolerance[0];
+		}
+
+		for(uint8_t i = 0; i < sensors; i++) {
+			valid[i] = rand() % 4 != 0;
+			order[i] = i;
+		}
+		for(uint8_t i = sensors - 1; i > 0; i--) {
+			uint8_t j = rand() % (i + 1), swap = order[i];
+			order[i] = order[j];
+			order[j] = swap;
+		}
+		for(uint8_t i = 0; i < sensors; i++) {
+			memcpy(&shuffled[i * AXES], &values[order[i] * AXES], AXES * sizeof(float));
+			valid_shuffled[i] = valid[order[i]];
+		}
+
+		uint8_t voters = sensor_vote(values, sensors, AXES, valid, tolerance, result, rejected);
+		CHECK(sensor_vote(shuffled, sensors, AXES, valid_shuffled, tolerance, result_shuffled, rejected_shuffled) == voters);
+		for(uint8_t i = 0; i < sensors; i++) {
+			CHECK(rejected_shuffled[i] == rejected[order[i]]);
+		}
+		// the kept readings are summed in another order
+		CHECK_NEAR(result_shuffled[0], result[0], 1e-3);
+		CHECK_NEAR(result_shuffled[1], result[1], 1e-5);
+	}
+}
+
+static void test_sensor_counts() {
+	float values[5 * AXES];
+	bool valid[5], rejected[5];
+	float result[AXES];
+
+	// one sensor gives its values, whatever they are
+	values[0] = 5.0f;
+	values[1] = -3.0f;
+	all_valid(valid, 1);
+	CHECK(sensor_vote(values, 1, AXES, valid, tolerance, result, rejected) == 1);
+	CHECK(!rejected[0] && result[0] == 5.0f && result[1] == -3.0f);
+
+	// two sensors are averaged: none can be told faulty
+	values[2] = 105.0f;
+	values[3] = -3.0f;
+	all_valid(valid, 2);
+	CHECK(sensor_vote(values, 2, AXES, valid, tolerance, result, rejected) == 2);
+	CHECK(!rejected[0] && !rejected[1]);
+	CHECK(result[0] == 55.0f && result[1] == -3.0f);
+
+	// five sensors, one of them off
+	healthy(values, 5);
+	values[3 * AXES + 1] = truth[1] + 10;
+	all_valid(valid, 5);
+	CHECK(sensor_vote(values, 5, AXES, valid, tolerance, result, rejected) == 5);
+	CHECK(!rejected[0] && !rejected[1] && !rejected[2] && rejected[3] && !rejected[4]);
+
+	// only the valid sensors vote, and the result is kept without any
+	valid[3] = false;
+	CHECK(sensor_vote(values, 5, AXES, valid, tolerance, result, rejected) == 4);
+	CHECK(!rejected[3]);
+	memset(valid, 0, sizeof(valid));
+	result[0] = 42.0f;
+	CHECK(sensor_vote(values, 5, AXES, valid, tolerance, result, rejected) == 0);
+	CHECK(result[0] == 42.0f);
+}
+
+static const float vector_tolerance[2] = { 0.1f, 0.01f }; // [m/s^2], [rad/s]
+
+// resting IMUs, the acceleration upwards and the rate around the roll axis
+static void healthy_imus(Vote_vectors* vectors, uint8_t sensors) {
+	for(uint8_t i = 0; i < sensors; i++) {
+		vectors[0].x[i] = noise(vector_tolerance[0]);
+		vectors[0].y[i] = noise(vector_tolerance[0]);
+		vectors[0].z[i] = 9.81f + noise(vector_tolerance[0]);
+		vectors[1].x[i] = 1.0f + noise(vector_tolerance[1]);
+		vectors[1].y[i] = noise(vector_tolerance[1]);
+		vectors[1].z[i] = noise(vector_tolerance[1]);
+	}
+}
+
+static void test_vector_norm_fault() {
+	for(int run = 0; run < RUNS; run++) {
+		uint8_t sensors = 3 + rand() % (VOTE_MAX_SENSORS - 2);
+		uint8_t faulty = rand() % sensors;
+		Vote_vectors vectors[2];
+		Vote_vector result[2];
+		bool valid[VOTE_MAX_SENSORS], rejected[VOTE_MAX_SENSORS];
+
+		healthy_imus(vectors, sensors);
+		// a gain fault: the right direction, twice the norm
+		vectors[0].x[faulty] *= 2;
+		vectors[0].y[faulty] *= 2;
+		vectors[0].z[faulty] *= 2;
+		all_valid(valid, sensors);
+
+		CHECK(sensor_vote_vectors(vectors, 2, sensors, valid, vector_tolerance, result, rejected) == sensors);
+		for(uint8_t i = 0; i < sensors; i++) {
+			CHECK(rejected[i] == (i == faulty));
+		}
+		CHECK_NEAR(result[0].z, 9.81f, vector_tolerance[0]);
+		CHECK_NEAR(result[1].x, 1.0f, vector_tolerance[1]);
+	}
+}
+
+static void test_vector_angle_fault() {
+	for(int run = 0; run < RUNS; run++) {
+		uint8_t sensors = 3 + rand() % (VOTE_MAX_SENSORS - 2);
+		uint8_t faulty = rand() % sensors;
+		Vote_vectors vectors[2];
+		Vote_vector result[2];
+		bool valid[VOTE_MAX_SENSORS], rejected[VOTE_MAX_SENSORS];
+
+		healthy_imus(vectors, sensors);
+		// a misaligned rate gyro: the same norm, turned by 10 degrees
+		float x = vectors[1].x[faulty], y = vectors[1].y[faulty];
+		vectors[1].x[faulty] = x * cosf(0.1745f) - y * sinf(0.1745f);
+		vectors[1].y[faulty] = x * sinf(0.1745f) + y * cosf(0.1745f);
+		all_valid(valid, sensors);
+
+		CHECK(sensor_vote_vectors(vectors, 2, sensors, valid, vector_tolerance, result, rejected) == sensors);
+		for(uint8_t i = 0; i < sensors; i++) {
+			CHECK(rejected[i] == (i == faulty));
+		}
+		// the turned rate is left out of the average
+		CHECK_NEAR(result[1].y, 0.0f, vector_tolerance[1]);
+	}
+}
+
+static void test_vector_all_rejected() {
+	const float unit[3] = { 1.0f, 1.0f, 1.0f };
+	Vote_vectors vectors[3];
+	Vote_vector result[3];
+	bool valid[3], rejected[3];
+
+	// each sensor is off on a kind of its own: all of them are discarded
+	memset(vectors, 0, sizeof(vectors));
+	for(uint8_t k = 0; k < 3; k++) {
+		vectors[k].x[k] = 100.0f;
+	}
+	all_valid(valid, 3);
+
+	CHECK(sensor_vote_vectors(vectors, 3, 3, valid, unit, result, rejected) == 3);
+	// the scores are equal, the first sensor is kept
+	CHECK(!rejected[0] && rejected[1] && rejected[2]);
+	CHECK(result[0].x == 100.0f && result[1].x == 0.0f && result[2].x == 0.0f);
+
+	// once the first one is less off, it is the closest
+	vectors[0].x[0] = 50.0f;
+	CHECK(sensor_vote_vectors(vectors, 3, 3, valid, unit, result, rejected) == 3);
+	CHECK(!rejected[0] && rejected[1] && rejected[2]);
+	vectors[0].x[0] = 100.0f;
+	vectors[1].x[1] = 50.0f;
+	CHECK(sensor_vote_vectors(vectors, 3, 3, valid, unit, result, rejected) == 3);
+	CHECK(rejected[0] && !rejected[1] && rejected[2]);
+	CHECK(result[0].x == 0.0f && result[1].x == 50.0f);
+}
+
+static void test_vector_few_sensors() {
+	Vote_vectors vectors[2];
+	Vote_vector result[2];
+	bool valid[2], rejected[2];
+
+	// no majority among two: both are averaged, however far apart
+	healthy_imus(vectors, 2);
+	vectors[0].z[1] = -9.81f;
+	all_valid(valid, 2);
+	CHECK(sensor_vote_vectors(vectors, 2, 2, valid, vector_tolerance, result, rejected) == 2);
+	CHECK(!rejected[0] && !rejected[1]);
+	CHECK_NEAR(result[0].z, (vectors[0].z[0] - 9.81f) / 2, 1e-6);
+}
+
+int main() {
+	srand(1);
+
+	test_agreeing_sensors_are_kept();
+	test_single_outlier_is_rejected();
+	test_order_does_not_matter();
+	test_sensor_counts();
+	test_vector_norm_fault();
+	test_vector_angle_fault();
+	test_vector_all_rejected();
+	test_vector_few_sensors();
+
+	return TEST_RESULT;
+}
@@ -0,0 +1,134 @@
+/*
+ * test_telemetry_store.c
+ *
+ * Round trip of the telemetry store: datagrams are stored as the telemetry senders do,
+ * the store thread runs on its own, and the backfill requests must give back exactly
+ * the stored datagrams of their range, in order and unchanged, as long as the ring of
+ * segments still holds them.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <storage/telemetry_store.h>
+
+#include "cmsis_os.h"
+
+#include <misc/datastructs.h>
+#include <storage/flash_runtime.h>
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "test.h"
+
+#define XBEE_QUEUE_LENGTH 16 // as in xbee.c
+#define RECORDS_PER_SEGMENT (TELEMETRY_STORE_SEGMENT_SIZE / TELEMETRY_STORE_RECORD_SIZE)
+#define BATCH 32 // datagrams stored at once, less than the staging records
+#define TIMEOUT_US 3000000
+
+osMessageQId xBeeQueueHandle;
+
+static FileSystem fs;
+static uint32_t produced = 0;
+
+FileSystem* get_flash_fs() {
+	return &fs;
+}
+
+// a datagram of its own for each sequence number, of a varying size
+static uint16_t make_datagram(uint32_t seq, uint8_t* datagram) {
+	uint16_t size = 20 + seq % (TELEMETRY_STORE_MAX_DATAGRAM_SIZE - 19);
+
+	for(uint16_t i = 0; i < size; i++) {
+		datagram[i] = (uint8_t) (seq * 31 + i * 7 + (seq >> 8));
+	}
+	return size;
+}
+
+static void wait_stored() {
+	TelemetryStore_stats stats = telemetry_store_get_stats();
+
+	for(uint32_t waited = 0; stats.stored + stats.dropped < produced && waited < TIMEOUT_US; waited += 100) {
+		usleep(100);
+		stats = telemetry_store_get_stats();
+	}
+}
+
+static void produce(uint32_t count) {
+	uint8_t datagram[TELEMETRY_STORE_MAX_DATAGRAM_SIZE];
+
+	for(uint32_t i = 0; i < count; i++) {
+		uint16_t size = make_datagram(produced, datagram);
+		telemetry_store(produced++, datagram, size);
+
+		if(produced % BATCH == 0) {
+			wait_stored();
+		}
+	}
+	wait_stored();
+}
+
+/*
+ * Requests [first_seq, last_seq] and checks that [expected_first, expected_last] comes back,
+ * nothing when expected_first > expected_last.
+ */
+static void round_trip(uint32_t first_seq, uint32_t last_seq, uint32_t expected_first, uint32_t expected_last) {
+	uint32_t expected = expected_first <= expected_last ? expected_last - expected_first + 1 : 0;
+	uint32_t received = 0, item, waited = 0;
+	uint8_t datagram[TELEMETRY_STORE_MAX_DATAGRAM_SIZE];
+
+	telemetry_store_request(first_seq, last_seq);
+
+	// a little longer than needed, for the datagrams that should not come
+	while(waited < (received < expected ? TIMEOUT_US : 20000)) {
+		if(!os_queue_get(xBeeQueueHandle, &item)) {
+			usleep(100);
+			waited += 100;
+			continue;
+		}
+
+		Telemetry_Message* m = (Telemetry_Message*) (uintptr_t) item;
+		uint16_t size = make_datagram(expected_first + received, datagram);
+
+		CHECK(received < expected);
+		CHECK(m->size == size && memcmp(m->ptr, datagram, size) == 0);
+		vPortFree(m->ptr);
+
+		received++;
+		waited = 0;
+	}
+
+	CHECK(received == expected);
+}
+
+static void* store_thread(void* args) {
+	TK_telemetry_store(args);
+	return NULL;
+}
+
+int main() {
+	pthread_t thread;
+
+	xBeeQueueHandle = os_queue_create(XBEE_QUEUE_LENGTH);
+	pthread_create(&thread, NULL, store_thread, NULL);
+
+	produce(1000);
+	round_trip(100, 199, 100, 199);
+	round_trip(0, 0, 0, 0);
+	round_trip(990, 2000, 990, 999); // the end of the range is not stored yet
+	round_trip(500, 400, 1, 0);
+
+	// across the segments, then beyond the ring: the first segments are overwritten
+	produce(RECORDS_PER_SEGMENT * (TELEMETRY_STORE_SEGMENTS + 2) - produced);
+	round_trip(5 * RECORDS_PER_SEGMENT - 5, 5 * RECORDS_PER_SEGMENT + 4, 5 * RECORDS_PER_SEGMENT - 5, 5 * RECORDS_PER_SEGMENT + 4);
+	round_trip(produced - 10, produced - 1, produced - 10, produced - 1);
+	round_trip(0, 50, 1, 0);
+	round_trip(2 * RECORDS_PER_SEGMENT - 5, 2 * RECORDS_PER_SEGMENT + 4, 2 * RECORDS_PER_SEGMENT, 2 * RECORDS_PER_SEGMENT + 4);
+
+	TelemetryStore_stats stats = telemetry_store_get_stats();
+	CHECK(stats.stored == produced && stats.dropped == 0);
+	printf("%u datagrams stored, %u resent\n", stats.stored, stats.resent);
+
+	return TEST_RESULT;
+}
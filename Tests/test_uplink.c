@@ -0,0 +1,168 @@
+/*
+ * test_uplink.c
+ *
+ * Loopback of the uplink commands between a ground station and the board, through a
+ * link that loses, delays and reorders the commands as well as their ACKs. The ground
+ * station sends a few commands at a time and retransmits each one until it is
+ * acknowledged: every command must be executed once and only once.
+ *
+ *  Created on: 17 Oct 2026
+ */
+
+#include <telemetry/uplink.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+
+#define COMMANDS 5000
+#define IN_FLIGHT 64 // commands and ACKs on the link at the same time
+#define MAX_LATENCY 8 // [ticks]
+#define RETRANSMIT_PERIOD 10 // [ticks]
+#define OUTSTANDING 4 // commands sent without their ACK yet
+
+typedef struct {
+	uint32_t seq;
+	uint32_t arrival;
+} Packet;
+
+typedef struct {
+	Packet packets[IN_FLIGHT];
+	uint32_t count;
+	uint32_t sent, lost;
+} Link;
+
+static int loss_percent;
+
+static void link_send(Link* link, uint32_t seq, uint32_t now) {
+	link->sent++;
+	if(rand() % 100 < loss_percent || link->count == IN_FLIGHT) {
+		link->lost++;
+		return;
+	}
+	link->packets[link->count++] = (Packet) { seq, now + 1 + rand() % MAX_LATENCY };
+}
+
+// takes a packet which has arrived, in any order, false if there is none
+static bool link_receive(Link* link, uint32_t now, uint32_t* seq) {
+	for(uint32_t i = 0; i < link->count; i++) {
+		if(link->packets[i].arrival <= now) {
+			*seq = link->packets[i].seq;
+			link->packets[i] = link->packets[--link->count];
+			return true;
+		}
+	}
+	return false;
+}
+
+/*
+ * Runs a session of the ground station, from the sequence number first, and returns
+ * the number of ticks it took. executed counts the executions of each command.
+ */
+static uint32_t run_session(UplinkWindow* window, uint32_t first, uint8_t* executed) {
+	Link up = { .count = 0 }, down = { .count = 0 };
+	bool acked[COMMANDS] = { false };
+	uint32_t last_sent[COMMANDS];
+	uint32_t next = 0, oldest = 0, now = 0, seq;
+
+	while(oldest < COMMANDS) {
+		// ground station: new commands, then the retransmissions
+		while(next < COMMANDS && next < oldest + OUTSTANDING) {
+			link_send(&up, first + next, now);
+			last_sent[next++] = now;
+		}
+		for(uint32_t k = oldest; k < next; k++) {
+			if(!acked[k] && now - last_sent[k] >= RETRANSMIT_PERIOD) {
+				link_send(&up, first + k, now);
+				last_sent[k] = now;
+			}
+		}
+
+		// board: every command is acknowledged, only the new ones are executed
+		while(link_receive(&up, now, &seq)) {
+			if(uplink_accept(window, seq) == UPLINK_NEW) {
+				executed[seq - first]++;
+			}
+			link_send(&down, seq, now);
+		}
+
+		while(link_receive(&down, now, &seq)) {
+			acked[seq - first] = true;
+		}
+		while(oldest < COMMANDS && acked[oldest]) {
+			oldest++;
+		}
+		now++;
+	}
+
+	return now;
+}
+
+static void test_lossy_link(int loss) {
+	UplinkWindow window;
+	static uint8_t executed[COMMANDS];
+
+	uplink_reset(&window);
+	memset(executed, 0, sizeof(executed));
+	loss_percent = loss;
+
+	uint32_t ticks = run_session(&window, 0, executed);
+
+	for(uint32_t k = 0; k < COMMANDS; k++) {
+		CHECK(executed[k] == 1);
+	}
+	printf("%d %% loss: %u commands in %u ticks\n", loss, COMMANDS, ticks);
+}
+
+static void test_ground_station_restart() {
+	UplinkWindow window;
+	static uint8_t executed[COMMANDS];
+
+	uplink_reset(&window);
+	loss_percent = 20;
+
+	// the first session reaches 5000, far beyond UPLINK_SESSION_GAP
+	memset(executed, 0, sizeof(executed));
+	run_session(&window, 0, executed);
+
+	// the ground station restarts from 0: its commands are new again
+	memset(executed, 0, sizeof(executed));
+	run_session(&window, 0, executed);
+	for(uint32_t k = 0; k < COMMANDS; k++) {
+		CHECK(executed[k] == 1);
+	}
+
+	// nor does the wrap around of the counter stop the commands
+	memset(executed, 0, sizeof(executed));
+	run_session(&window, UINT32_MAX - COMMANDS / 2, executed);
+	for(uint32_t k = 0; k < COMMANDS; k++) {
+		CHECK(executed[k] == 1);
+	}
+}
+
+static void test_verdicts() {
+	UplinkWindow window;
+
+	uplink_reset(&window);
+	CHECK(uplink_accept(&window, 2000) == UPLINK_NEW);
+	CHECK(uplink_accept(&window, 2000) == UPLINK_DUPLICATE);
+	CHECK(uplink_accept(&window, 1990) == UPLINK_NEW); // late, but never seen
+	CHECK(uplink_accept(&window, 1990) == UPLINK_DUPLICATE);
+	CHECK(uplink_accept(&window, 2000 - UPLINK_WINDOW_SIZE - 1) == UPLINK_STALE);
+	CHECK(uplink_accept(&window, 2000 - UPLINK_SESSION_GAP) == UPLINK_STALE);
+	CHECK(uplink_accept(&window, 2000 - UPLINK_SESSION_GAP - 1) == UPLINK_NEW);
+	CHECK(uplink_accept(&window, 2000) == UPLINK_NEW); // the previous session is forgotten
+}
+
+int main() {
+	srand(1);
+
+	test_verdicts();
+	test_lossy_link(0);
+	test_lossy_link(30);
+	test_lossy_link(60);
+	test_ground_station_restart();
+
+	return TEST_RESULT;
+}